@@ -0,0 +1,95 @@
+#include "CsvReader.h"
+
+#include <cstring>
+
+/**
+ * @brief Constructs a reader with no file open.
+ */
+CsvReader::CsvReader()
+    : data(nullptr), size(0), position(0), rowStart(0), rowEnd(0), cursor(0), rowFinished(true), lineNumber(0)
+{
+}
+
+/**
+ * @brief Maps a file into memory for reading.
+ * @param path The file to read.
+ * @return False if the file could not be opened or mapped.
+ */
+bool CsvReader::open(const std::string &path)
+{
+    filename = path;
+    if (!file.open(path))
+    {
+        return false;
+    }
+    data = file.data();
+    size = file.size();
+    return true;
+}
+
+/**
+ * @brief Moves to the next non-empty row.
+ * @return False at the end of the file.
+ */
+bool CsvReader::nextRow()
+{
+    while (position < size)
+    {
+        ++lineNumber;
+        rowStart = position;
+        const void *newline = std::memchr(data + position, '\n', size - position);
+        rowEnd = newline ? static_cast<size_t>(static_cast<const char *>(newline) - data) : size;
+        position = rowEnd + 1;
+        if (rowEnd > rowStart && data[rowEnd - 1] == '\r')
+        {
+            --rowEnd;
+        }
+
+        if (rowEnd > rowStart)
+        {
+            cursor = rowStart;
+            rowFinished = false;
+            return true;
+        }
+    }
+    rowFinished = true;
+    return false;
+}
+
+/**
+ * @brief Reads the next field of the current row, trimmed of surrounding spaces.
+ * @param field Set to the field.
+ * @return False once every field of the row was read.
+ */
+bool CsvReader::nextField(std::string_view &field)
+{
+    if (rowFinished)
+    {
+        return false;
+    }
+
+    std::string_view rest(data + cursor, rowEnd - cursor);
+    size_t comma = rest.find(',');
+    if (comma == std::string_view::npos)
+    {
+        field = trimField(rest);
+        rowFinished = true;
+    }
+    else
+    {
+        field = trimField(rest.substr(0, comma));
+        cursor += comma + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Formats the location of a token of the current row for error messages.
+ * @param token A view into the current row.
+ * @return The location as file:line:column.
+ */
+std::string CsvReader::location(std::string_view token) const
+{
+    size_t column = token.data() >= data + rowStart ? static_cast<size_t>(token.data() - (data + rowStart)) + 1 : 1;
+    return filename + ":" + std::to_string(lineNumber) + ":" + std::to_string(column);
+}
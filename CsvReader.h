@@ -0,0 +1,83 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "MappedFile.h"
+
+// Reader of comma-separated files over a read-only memory mapping of the file.
+// Rows and fields are views into the mapping, so reading allocates nothing per
+// row or field; they stay valid until the reader is destroyed. Errors are located
+// by line and column for messages such as "schedule.csv:4:17: unknown team".
+class CsvReader
+{
+public:
+    CsvReader();
+
+    bool open(const std::string &path);
+    bool nextRow();
+    bool nextField(std::string_view &field);
+    std::string location(std::string_view token) const;
+
+private:
+    std::string filename; // Name of the file, for error locations
+    MappedFile file;      // Mapping of the file
+    const char *data;     // Contents of the file
+    size_t size;          // Size of the contents
+
+    size_t position;  // Start of the next row
+    size_t rowStart;  // Start of the current row
+    size_t rowEnd;    // End of the current row, before any line terminator
+    size_t cursor;    // Start of the next field of the current row
+    bool rowFinished; // Whether every field of the current row was read
+    int lineNumber;   // Line of the current row (1-based)
+};
+
+/**
+ * @brief Trims spaces and tabs from both ends of a field.
+ * @param text The field.
+ * @return The trimmed view.
+ */
+inline std::string_view trimField(std::string_view text)
+{
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos)
+    {
+        return text.substr(text.size());
+    }
+    size_t last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Parses a whole field as a number.
+ * @param text The field.
+ * @param value Set to the number on success.
+ * @return False if the field is empty, not a number, or has trailing characters.
+ */
+template <typename T>
+bool parseField(std::string_view text, T &value)
+{
+    const char *end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == end;
+}
+
+/**
+ * @brief Splits the next token off a field.
+ * @param text The rest of the field; advanced past the token and its separator.
+ * @param separator The character between tokens.
+ * @return The token, empty once the field is exhausted.
+ */
+inline std::string_view nextToken(std::string_view &text, char separator)
+{
+    size_t end = text.find(separator);
+    std::string_view token = text.substr(0, end);
+    text = end == std::string_view::npos ? text.substr(text.size()) : text.substr(end + 1);
+    return token;
+}
+
+#endif // CSVREADER_H
@@ -0,0 +1,189 @@
+#ifndef ELOMATH_H
+#define ELOMATH_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "SimdLanes.h"
+
+// Elo math shared by the scalar and the batched season kernels.
+// The functions are templates over double and LaneDouble and only use
+// +, -, *, / and exponent bit manipulation, so a lane of the batched kernel
+// computes bit-for-bit the same odds and Elo changes as the scalar kernel.
+// The Makefile builds with -ffp-contract=off to keep it that way.
+//
+// MathMode::Exact evaluates e^x to within a few ulp of std::exp. MathMode::Fast
+// trades accuracy for a shorter polynomial; the logistic it yields is within
+// FAST_LOGISTIC_MAX_ERROR of the exact one.
+enum class MathMode
+{
+    Exact,
+    Fast
+};
+
+namespace EloMath
+{
+    // Maximum absolute error of the fast logistic against the std::exp logistic
+    constexpr double FAST_LOGISTIC_MAX_ERROR = 1e-6;
+
+    /**
+     * @brief Computes 2^k for an integral k in [-1022, 1023].
+     * @param k The exponent as a double.
+     * @return 2 to the power of k.
+     */
+    inline double pow2(double k)
+    {
+        int64_t bits = (static_cast<int64_t>(k) + 1023) << 52;
+        double result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    /**
+     * @brief Computes 2^k for integral k in [-1022, 1023] in every lane.
+     * @param k The exponents.
+     * @return 2 to the power of k in every lane.
+     */
+    inline LaneDouble pow2(LaneDouble k)
+    {
+        LaneInt bits = (__builtin_convertvector(k, LaneInt) + 1023) << 52;
+        LaneDouble result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    /**
+     * @brief Clamps an argument of exp to the range where the result is a normal double.
+     * @param x The argument.
+     * @return The clamped argument.
+     */
+    inline double clampExpArgument(double x)
+    {
+        return x < -700.0 ? -700.0 : (x > 700.0 ? 700.0 : x);
+    }
+
+    /**
+     * @brief Clamps the arguments of exp to the range where the result is a normal double.
+     * @param x The arguments.
+     * @return The clamped arguments.
+     */
+    inline LaneDouble clampExpArgument(LaneDouble x)
+    {
+        LaneDouble low = broadcastLanes(-700.0);
+        LaneDouble high = broadcastLanes(700.0);
+        x = x < low ? low : x;
+        return x > high ? high : x;
+    }
+
+    /**
+     * @brief Reduces an argument of exp to r = x - k ln 2 with |r| <= ln 2 / 2.
+     * @param x The argument.
+     * @param k Set to round(x / ln 2).
+     * @return The reduced argument r.
+     */
+    template <typename T>
+    inline T reduceExpArgument(T x, T &k)
+    {
+        const double LOG2E = 1.4426950408889634074;
+        const double LN2_HIGH = 6.93147180369123816490e-01; // ln 2 with trailing zero bits
+        const double LN2_LOW = 1.90821492927058770002e-10;  // ln 2 - LN2_HIGH
+        const double ROUNDING_SHIFT = 6755399441055744.0;   // 1.5 * 2^52
+
+        x = clampExpArgument(x);
+        k = (x * LOG2E + ROUNDING_SHIFT) - ROUNDING_SHIFT;
+        return (x - k * LN2_HIGH) - k * LN2_LOW;
+    }
+
+    /**
+     * @brief Computes e^x.
+     *
+     * e^r of the reduced argument is evaluated with its degree-13 Taylor polynomial,
+     * whose truncation error is below 1e-17; the result is within a few ulp of std::exp.
+     *
+     * @param x The argument.
+     * @return e to the power of x.
+     */
+    template <typename T>
+    inline T exp(T x)
+    {
+        T k;
+        T r = reduceExpArgument(x, k);
+
+        T p = r * (1.0 / 6227020800.0) + (1.0 / 479001600.0);
+        p = p * r + (1.0 / 39916800.0);
+        p = p * r + (1.0 / 3628800.0);
+        p = p * r + (1.0 / 362880.0);
+        p = p * r + (1.0 / 40320.0);
+        p = p * r + (1.0 / 5040.0);
+        p = p * r + (1.0 / 720.0);
+        p = p * r + (1.0 / 120.0);
+        p = p * r + (1.0 / 24.0);
+        p = p * r + (1.0 / 6.0);
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        return p * pow2(k);
+    }
+
+    /**
+     * @brief Computes an approximation of e^x.
+     *
+     * e^r of the reduced argument is evaluated with its degree-5 Taylor polynomial,
+     * for a relative error below 2.5e-6.
+     *
+     * @param x The argument.
+     * @return e to the power of x.
+     */
+    template <typename T>
+    inline T fastExp(T x)
+    {
+        T k;
+        T r = reduceExpArgument(x, k);
+
+        T p = r * (1.0 / 120.0) + (1.0 / 24.0);
+        p = p * r + (1.0 / 6.0);
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        return p * pow2(k);
+    }
+
+    /**
+     * @brief Computes the win probability for an Elo rating difference.
+     * @param eloDifference The Elo rating difference.
+     * @param mode Whether to use the exact or the fast exp.
+     * @return 1 / (1 + e^(-eloDifference / 400)).
+     */
+    template <typename T>
+    inline T logistic(T eloDifference, MathMode mode)
+    {
+        T power = mode == MathMode::Fast ? fastExp(-eloDifference / 400.0) : exp(-eloDifference / 400.0);
+        return 1.0 / (power + 1.0);
+    }
+
+    /**
+     * @brief Computes the Elo rating change of the home team after a game.
+     * @param eloDifference The home team's Elo rating minus the away team's before the game.
+     * @param actualResult 1 for a home win, 0 for an away win and 0.5 for a tie.
+     * @param marginLogarithm The natural logarithm of the point difference plus one.
+     * @param mode Whether to use the exact or the fast exp.
+     * @return The Elo rating change of the home team.
+     */
+    template <typename T>
+    inline T eloChange(T eloDifference, T actualResult, T marginLogarithm, MathMode mode)
+    {
+        const double K = 4.0;                   // K-factor
+        const double MOV_MULTIPLIER_BASE = 2.2; // Base for margin-of-victory multiplier
+        const double MOV_SCALE = 0.001;         // Scaling factor for Elo difference
+
+        T forecastDelta = actualResult - logistic(eloDifference, mode);
+        T movMultiplier = marginLogarithm * MOV_MULTIPLIER_BASE;
+        T eloAdjustment = movMultiplier * (eloDifference * MOV_SCALE + MOV_MULTIPLIER_BASE);
+
+        return forecastDelta * K * eloAdjustment;
+    }
+}
+
+#endif // ELOMATH_H
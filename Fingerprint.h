@@ -0,0 +1,68 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 64-bit FNV-1a hash accumulated over raw bytes.
+// Used to recognise a league and to checksum files written by the simulator;
+// it is fast and stable across runs, not a cryptographic hash.
+struct Fingerprint
+{
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a offset basis
+
+    /**
+     * @brief Adds raw bytes to the hash.
+     * @param data The bytes to add.
+     * @param size The number of bytes.
+     */
+    void add(const void *data, size_t size)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL; // FNV-1a prime
+        }
+    }
+
+    /**
+     * @brief Adds whole 64-bit words to the hash, one multiply per word instead of per byte.
+     *
+     * Mixes less than add, but is eight times faster for checksumming large files.
+     *
+     * @param words The words to add.
+     * @param count The number of words.
+     */
+    void addWords(const uint64_t *words, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            hash ^= words[i];
+            hash *= 1099511628211ULL; // FNV-1a prime
+        }
+    }
+
+    /**
+     * @brief Adds the bytes of a value to the hash.
+     * @param value The value to add.
+     */
+    template <typename T>
+    void add(const T &value)
+    {
+        add(&value, sizeof(value));
+    }
+
+    /**
+     * @brief Adds the elements of a vector to the hash.
+     * @param values The values to add.
+     */
+    template <typename T>
+    void add(const std::vector<T> &values)
+    {
+        add(values.data(), values.size() * sizeof(T));
+    }
+};
+
+#endif // FINGERPRINT_H
@@ -0,0 +1,451 @@
+#include "ForecastServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Names of the request types in the STATS reply
+static const char *const REQUEST_NAMES[] = {"RESULT", "RESET", "RUN", "STATS"};
+
+// Most seasons one RUN may simulate, so no request holds a worker for long
+static const int MAX_RUN_SEASONS = 1000000;
+
+/**
+ * @brief Records the latency of one request.
+ * @param microseconds The latency.
+ */
+void LatencyStats::add(double microseconds)
+{
+    ++count;
+    totalMicroseconds += microseconds;
+    maxMicroseconds = std::max(maxMicroseconds, microseconds);
+
+    int bucket = microseconds < 1.0 ? 0 : static_cast<int>(std::log2(microseconds) * 4.0);
+    ++buckets[std::min(bucket, NUM_BUCKETS - 1)];
+}
+
+/**
+ * @brief Estimates a latency percentile.
+ * @param fraction The fraction of requests at or below the returned latency (e.g. 0.99).
+ * @return The upper bound of the bucket holding the percentile, in microseconds.
+ */
+double LatencyStats::percentile(double fraction) const
+{
+    long long rank = static_cast<long long>(std::ceil(fraction * count));
+    long long seen = 0;
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank && seen > 0)
+        {
+            return std::min(std::exp2((bucket + 1) / 4.0), maxMicroseconds);
+        }
+    }
+    return maxMicroseconds;
+}
+
+/**
+ * @brief Constructs a server for a loaded league.
+ * @param league The league to forecast.
+ * @param workerCount The number of connections served at once.
+ */
+ForecastServer::ForecastServer(NFLSimulator &league, int workerCount)
+    : simulator(league), numWorkers(std::max(1, workerCount))
+{
+}
+
+/**
+ * @brief Listens on a UNIX domain socket and serves connections until the process ends.
+ * @param socketPath The path of the socket; an existing file there is replaced.
+ * @return False if the socket could not be set up.
+ */
+bool ForecastServer::serve(const std::string &socketPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Error: Socket path is too long: " << socketPath << std::endl;
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        std::cerr << "Error: Could not create socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    unlink(socketPath.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(listener, 64) < 0)
+    {
+        std::cerr << "Error: Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listener);
+        return false;
+    }
+
+    // Workers write to the pipe after every request so the reading thread polls that connection again
+    int wakePipe[2];
+    if (pipe(wakePipe) < 0)
+    {
+        std::cerr << "Error: Could not create pipe: " << std::strerror(errno) << std::endl;
+        close(listener);
+        return false;
+    }
+    wakeDescriptor = wakePipe[1];
+    fcntl(wakeDescriptor, F_SETFL, O_NONBLOCK); // A full pipe already wakes the reading thread
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back(&ForecastServer::workerLoop, this);
+    }
+    std::cout << "Serving forecasts on " << socketPath << " with " << numWorkers << " workers" << std::endl;
+
+    // Read the listener, the wake pipe and every connection without a request in the pool
+    std::unordered_map<int, ClientConnection> connections;
+    std::vector<pollfd> descriptors;
+    char chunk[4096];
+    while (true)
+    {
+        descriptors.clear();
+        descriptors.push_back({listener, POLLIN, 0});
+        descriptors.push_back({wakePipe[0], POLLIN, 0});
+        for (const auto &connectionPair : connections)
+        {
+            if (!connectionPair.second.busy)
+                descriptors.push_back({connectionPair.first, POLLIN, 0});
+        }
+
+        if (poll(descriptors.data(), descriptors.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "Error: poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        if (descriptors[0].revents & POLLIN)
+        {
+            int connection = accept(listener, nullptr, nullptr);
+            if (connection >= 0)
+            {
+                connections[connection] = ClientConnection();
+            }
+            else if (errno != EINTR && errno != ECONNABORTED)
+            {
+                std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+                break;
+            }
+        }
+
+        if (descriptors[1].revents & POLLIN)
+        {
+            ssize_t drained = read(wakePipe[0], chunk, sizeof(chunk));
+            (void)drained;
+            finishRequests(connections);
+        }
+
+        for (size_t i = 2; i < descriptors.size(); ++i)
+        {
+            if (descriptors[i].revents == 0)
+                continue;
+
+            int connection = descriptors[i].fd;
+            ssize_t received = recv(connection, chunk, sizeof(chunk), 0);
+            if (received <= 0)
+            {
+                close(connection);
+                connections.erase(connection);
+                continue;
+            }
+            ClientConnection &client = connections.at(connection);
+            client.buffer.append(chunk, static_cast<size_t>(received));
+            dispatchRequest(connection, client);
+        }
+    }
+
+    // Workers block forever waiting for requests, so the process ends here
+    close(listener);
+    for (auto &worker : workers)
+    {
+        worker.detach();
+    }
+    return false;
+}
+
+/**
+ * @brief Queues the next complete request line of a connection for the workers.
+ * @param connection The connected socket.
+ * @param client The input of the connection; marked busy if a request was queued.
+ */
+void ForecastServer::dispatchRequest(int connection, ClientConnection &client)
+{
+    size_t newline = client.buffer.find('\n');
+    if (client.busy || newline == std::string::npos)
+    {
+        return;
+    }
+
+    std::string line = client.buffer.substr(0, newline);
+    client.buffer.erase(0, newline + 1);
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+    client.busy = true;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pendingRequests.push_back({connection, std::move(line)});
+    }
+    queueCondition.notify_one();
+}
+
+/**
+ * @brief Hands the connections of answered requests back to the reading thread.
+ *
+ * Connections whose client quit are closed; the others get their next buffered request
+ * queued, or are polled for more input.
+ *
+ * @param connections The open connections.
+ */
+void ForecastServer::finishRequests(std::unordered_map<int, ClientConnection> &connections)
+{
+    std::vector<FinishedRequest> finished;
+    {
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        finished.swap(finishedRequests);
+    }
+
+    for (const auto &request : finished)
+    {
+        if (request.close)
+        {
+            close(request.connection);
+            connections.erase(request.connection);
+            continue;
+        }
+        ClientConnection &client = connections.at(request.connection);
+        client.busy = false;
+        dispatchRequest(request.connection, client);
+    }
+}
+
+/**
+ * @brief Answers queued requests one at a time.
+ */
+void ForecastServer::workerLoop()
+{
+    while (true)
+    {
+        PendingRequest request;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]
+                                { return !pendingRequests.empty(); });
+            request = std::move(pendingRequests.front());
+            pendingRequests.pop_front();
+        }
+
+        bool quit = false;
+        std::string reply = handleRequest(request.line, quit);
+        size_t sent = 0;
+        while (sent < reply.size())
+        {
+            ssize_t written = send(request.connection, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0)
+            {
+                quit = true;
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            finishedRequests.push_back({request.connection, quit});
+        }
+        char wake = 0;
+        ssize_t written = write(wakeDescriptor, &wake, 1);
+        (void)written;
+    }
+}
+
+/**
+ * @brief Answers one request and records its latency.
+ * @param line The request line.
+ * @param quit Set if the client asked to close the connection.
+ * @return The reply, ending in a newline.
+ */
+std::string ForecastServer::handleRequest(const std::string &line, bool &quit)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::istringstream request(line);
+    std::string command;
+    request >> command;
+
+    std::string reply;
+    RequestType type;
+    if (command == "RESULT")
+    {
+        type = REQUEST_RESULT;
+        reply = handleResult(request);
+    }
+    else if (command == "RESET")
+    {
+        type = REQUEST_RESET;
+        simulator.resetResults();
+        reply = "OK\n";
+    }
+    else if (command == "RUN")
+    {
+        type = REQUEST_RUN;
+        reply = handleRun(request);
+    }
+    else if (command == "STATS")
+    {
+        type = REQUEST_STATS;
+        reply = formatStats();
+    }
+    else if (command == "QUIT")
+    {
+        quit = true;
+        return "OK\n";
+    }
+    else
+    {
+        return "ERROR unknown request: " + command + "\n";
+    }
+
+    double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(statsMutex);
+    requestStats[type].add(microseconds);
+    return reply;
+}
+
+/**
+ * @brief Sets a game result: RESULT <team> <week> <home>-<away>.
+ * @param request The request after the command.
+ * @return The reply.
+ */
+std::string ForecastServer::handleResult(std::istringstream &request)
+{
+    std::string team;
+    int week, homeScore, awayScore;
+    char dash;
+    if (!(request >> team >> week >> homeScore >> dash >> awayScore) || dash != '-')
+    {
+        return "ERROR usage: RESULT <team> <week> <home>-<away>\n";
+    }
+
+    if (!simulator.setResult(team, week, homeScore, awayScore))
+    {
+        return "ERROR no game for " + team + " in week " + std::to_string(week) + "\n";
+    }
+    return "OK\n";
+}
+
+/**
+ * @brief Runs a forecast: RUN <seasons> [options].
+ * @param request The request after the command.
+ * @return The per-team results followed by END, or an error.
+ */
+std::string ForecastServer::handleRun(std::istringstream &request)
+{
+    ForecastOptions options;
+    options.threads = 1; // Requests run in parallel on the worker pool instead
+    if (!(request >> options.seasons) || options.seasons <= 0)
+    {
+        return "ERROR usage: RUN <seasons> [seed=<n>] [threads=<n>] [antithetic] [control-variates] [fast-math] [target=<team>] [tilt=<elo>]\n";
+    }
+
+    std::string option;
+    while (request >> option)
+    {
+        size_t equals = option.find('=');
+        std::string key = option.substr(0, equals);
+        std::string value = equals == std::string::npos ? "" : option.substr(equals + 1);
+        try
+        {
+            if (key == "seed")
+                options.seed = std::stoull(value);
+            else if (key == "threads")
+                options.threads = std::min(std::max(std::stoi(value), 1), numWorkers); // At most the pool's share of the cores
+            else if (key == "antithetic")
+                options.antithetic = true;
+            else if (key == "control-variates")
+                options.controlVariates = true;
+            else if (key == "fast-math")
+                options.fastMath = true;
+            else if (key == "target")
+                options.target = value;
+            else if (key == "tilt")
+                options.tilt = std::stod(value);
+            else
+                return "ERROR unknown option: " + option + "\n";
+        }
+        catch (const std::exception &)
+        {
+            return "ERROR invalid option: " + option + "\n";
+        }
+    }
+
+    if (options.seasons > MAX_RUN_SEASONS)
+    {
+        return "ERROR at most " + std::to_string(MAX_RUN_SEASONS) + " seasons per request\n";
+    }
+
+    Forecast forecast;
+    if (!simulator.run(options, forecast))
+    {
+        return "ERROR invalid forecast options\n";
+    }
+
+    std::ostringstream reply;
+    reply << "OK " << forecast.seasons << " " << forecast.seed << "\n" << std::fixed << std::setprecision(4);
+    for (const auto &team : forecast.teams)
+    {
+        reply << team.abbreviation << " " << team.averageWins << " " << team.winStandardDeviation;
+        for (double probability : team.roundProbabilities)
+        {
+            reply << " " << probability;
+        }
+        reply << "\n";
+    }
+    reply << "END\n";
+    return reply.str();
+}
+
+/**
+ * @brief Formats the latency statistics: one line per request type with the count and
+ *        the mean, median, 95th, 99th percentile and maximum latency in microseconds.
+ * @return The reply.
+ */
+std::string ForecastServer::formatStats()
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    std::ostringstream reply;
+    reply << std::fixed << std::setprecision(1);
+    for (int type = 0; type < NUM_REQUEST_TYPES; ++type)
+    {
+        const LatencyStats &stats = requestStats[type];
+        double mean = stats.count > 0 ? stats.totalMicroseconds / stats.count : 0.0;
+        reply << REQUEST_NAMES[type] << " count=" << stats.count << " mean_us=" << mean
+              << " p50_us=" << stats.percentile(0.50) << " p95_us=" << stats.percentile(0.95)
+              << " p99_us=" << stats.percentile(0.99) << " max_us=" << stats.maxMicroseconds << "\n";
+    }
+    reply << "END\n";
+    return reply.str();
+}
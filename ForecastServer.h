@@ -0,0 +1,109 @@
+#ifndef FORECASTSERVER_H
+#define FORECASTSERVER_H
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "NFLSimulator.h"
+
+// Latency distribution of one request type, in constant memory.
+// Latencies are counted in buckets a quarter octave wide, so percentiles are
+// reported to within 19% of the true value.
+struct LatencyStats
+{
+    static constexpr int NUM_BUCKETS = 128; // Up to 2^32 microseconds
+
+    long long count = 0;
+    double totalMicroseconds = 0.0;
+    double maxMicroseconds = 0.0;
+    std::array<long long, NUM_BUCKETS> buckets{};
+
+    void add(double microseconds);
+    double percentile(double fraction) const;
+};
+
+// Long-lived forecast server on a UNIX domain socket.
+// Clients send one request per line and get a reply ending in "OK"/"END" or a
+// single "ERROR" line:
+//   RESULT <team> <week> <home>-<away>  set a game result for all later forecasts (0-0 clears it)
+//   RESET                               restore the results of the schedule file
+//   RUN <seasons> [seed=<n>] [threads=<n>] [antithetic] [control-variates] [fast-math] [target=<team>] [tilt=<elo>]
+//                                       forecast of at most 1000000 seasons on 1 to the worker count
+//                                       threads; one line per team with average wins, win SD and
+//                                       the wildcard ... championship probabilities
+//   STATS                               request count and latency percentiles per request type
+//   QUIT                                close the connection
+// One thread reads every connection and queues each request line to a fixed pool
+// of worker threads, so a worker is only busy while a request runs and idle clients
+// cost nothing. A connection has at most one request in the pool, so its requests
+// are answered in order. Forecasts run concurrently, each from the results set
+// before it started.
+class ForecastServer
+{
+public:
+    ForecastServer(NFLSimulator &league, int workerCount);
+
+    bool serve(const std::string &socketPath);
+
+private:
+    // Request types with their own latency statistics
+    enum RequestType
+    {
+        REQUEST_RESULT,
+        REQUEST_RESET,
+        REQUEST_RUN,
+        REQUEST_STATS,
+        NUM_REQUEST_TYPES
+    };
+
+    // A request line queued for the workers
+    struct PendingRequest
+    {
+        int connection;   // The socket to reply on
+        std::string line; // The request, without its newline
+    };
+
+    // A request the workers have answered
+    struct FinishedRequest
+    {
+        int connection; // The socket the reply went to
+        bool close;     // Whether the client quit or the reply could not be sent
+    };
+
+    // Input of a connection not yet handed to the workers
+    struct ClientConnection
+    {
+        std::string buffer; // Received bytes after the last dispatched request
+        bool busy = false;  // Whether a request of the connection is queued or running
+    };
+
+    void workerLoop();
+    void dispatchRequest(int connection, ClientConnection &client);
+    void finishRequests(std::unordered_map<int, ClientConnection> &connections);
+    std::string handleRequest(const std::string &line, bool &quit);
+    std::string handleResult(std::istringstream &request);
+    std::string handleRun(std::istringstream &request);
+    std::string formatStats();
+
+    NFLSimulator &simulator; // League shared by all connections
+    int numWorkers;          // Worker threads serving connections
+
+    std::mutex queueMutex;                  // Guards pendingRequests
+    std::condition_variable queueCondition; // Signals a new pending request
+    std::deque<PendingRequest> pendingRequests; // Requests waiting for a worker
+
+    std::mutex finishedMutex;                     // Guards finishedRequests
+    std::vector<FinishedRequest> finishedRequests; // Answered requests not yet seen by the reading thread
+    int wakeDescriptor = -1;                      // Write end of the pipe that wakes the reading thread
+
+    std::mutex statsMutex;                                   // Guards requestStats
+    std::array<LatencyStats, NUM_REQUEST_TYPES> requestStats; // Latency per request type
+};
+
+#endif // FORECASTSERVER_H
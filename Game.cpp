@@ -1,19 +1,43 @@
 #include "Game.h"
 
-// Constructor that initializes a Game object from a vector of tokens and a map of teams by abbreviation
+// Constructor that initializes a Game object from a parsed schedule entry
 /**
  * @brief Constructs a Game object.
- * @param tokens A vector of strings containing game details.
- * @param teamMapByAbbreviation A map of team abbreviations to Team objects.
+ * @param week The week of the game (0-based).
+ * @param home A shared pointer to the home team.
+ * @param away A shared pointer to the away team.
+ * @param complete Whether the game has been played.
+ * @param homeScore The score of the home team.
+ * @param awayScore The score of the away team.
  */
-Game::Game(std::vector<std::string> tokens, const std::unordered_map<std::string, std::shared_ptr<Team>> &teamMapByAbbreviation)
-    : homeTeam(teamMapByAbbreviation.at(tokens[1])),
-      awayTeam(tokens[2] == "BYE" ? homeTeam : teamMapByAbbreviation.at(tokens[2])),
-      byeWeek(tokens[2] == "BYE"),
-      gameComplete(byeWeek || tokens[3] == "Y"),
-      weekNumber(std::stoi(tokens[0])),
-      homeTeamScore(!byeWeek ? std::stoi(tokens[4]) : 0),
-      awayTeamScore(!byeWeek ? std::stoi(tokens[5]) : 0),
+Game::Game(int week, const std::shared_ptr<Team> &home, const std::shared_ptr<Team> &away, bool complete, int homeScore, int awayScore)
+    : homeTeam(home),
+      awayTeam(away),
+      byeWeek(false),
+      gameComplete(complete),
+      weekNumber(week),
+      homeTeamScore(homeScore),
+      awayTeamScore(awayScore),
+      homeTeamOdds(0.0),
+      fieldAdvantage(0.0),
+      eloRatingChange(0.0)
+{
+}
+
+// Constructor that initializes a bye week
+/**
+ * @brief Constructs a bye week, which counts as complete.
+ * @param week The week of the bye (0-based).
+ * @param team A shared pointer to the team on its bye.
+ */
+Game::Game(int week, const std::shared_ptr<Team> &team)
+    : homeTeam(team),
+      awayTeam(team),
+      byeWeek(true),
+      gameComplete(true),
+      weekNumber(week),
+      homeTeamScore(0),
+      awayTeamScore(0),
       homeTeamOdds(0.0),
       fieldAdvantage(0.0),
       eloRatingChange(0.0)
@@ -39,6 +63,29 @@ Game::Game(const std::shared_ptr<Team> &homeTeam, const std::shared_ptr<Team> &a
 {
 }
 
+// Constructor that copies a Game object onto a different pair of Team objects
+/**
+ * @brief Constructs a copy of a Game object that refers to other Team objects.
+ * @param other The game to copy.
+ * @param home A shared pointer to the home team of the copy.
+ * @param away A shared pointer to the away team of the copy.
+ */
+Game::Game(const Game &other, const std::shared_ptr<Team> &home, const std::shared_ptr<Team> &away)
+    : homeTeam(home),
+      awayTeam(away),
+      byeWeek(other.byeWeek),
+      gameComplete(other.gameComplete),
+      weekNumber(other.weekNumber),
+      homeTeamScore(other.homeTeamScore),
+      awayTeamScore(other.awayTeamScore),
+      homeTeamOdds(other.homeTeamOdds),
+      fieldAdvantage(other.fieldAdvantage),
+      eloRatingChange(other.eloRatingChange),
+      userSet(other.userSet),
+      oddsDirty(other.oddsDirty)
+{
+}
+
 // Destructor for the Game class
 /**
  * @brief Destroys the Game object.
@@ -49,27 +96,43 @@ Game::~Game()
 
 // Function to print the game details
 /**
- * @brief Prints the game details.
- * @param primary A shared pointer to the primary team.
- * @return A string representing the game details.
+ * @brief Writes the game details from one team's point of view: opponent, score and win odds.
+ * @param report The report to write to.
+ * @param primary The team whose schedule is printed.
  */
-std::string Game::getGameDetails(const std::shared_ptr<Team> &primary) const
+void Game::writeGameDetails(ReportWriter &report, const Team &primary) const
 {
     if (byeWeek)
     {
-        return "BYE";
+        report.write("BYE");
+        return;
     }
-    if (homeTeam->getName() == primary->getName())
+    if (homeTeam.get() == &primary)
     {
-        return awayTeam->getAbbreviation() + "|" + std::to_string(homeTeamScore) +
-               "-" + std::to_string(awayTeamScore) + "|" + std::to_string(homeTeamOdds * 100) + "%";
+        report.write(awayTeam->getAbbreviation());
+        report.write("|");
+        report.writeInt(homeTeamScore);
+        report.write("-");
+        report.writeInt(awayTeamScore);
+        report.write("|");
+        report.writeFixed(homeTeamOdds * 100, 6);
+        report.write("%");
+        return;
     }
-    if (awayTeam->getName() == primary->getName())
+    if (awayTeam.get() == &primary)
     {
-        return "@" + homeTeam->getAbbreviation() + "|" + std::to_string(awayTeamScore) +
-               "-" + std::to_string(homeTeamScore) + "|" + std::to_string((1 - homeTeamOdds) * 100) + "%";
+        report.write("@");
+        report.write(homeTeam->getAbbreviation());
+        report.write("|");
+        report.writeInt(awayTeamScore);
+        report.write("-");
+        report.writeInt(homeTeamScore);
+        report.write("|");
+        report.writeFixed((1 - homeTeamOdds) * 100, 6);
+        report.write("%");
+        return;
     }
-    return "Error: game not found";
+    report.write("Error: game not found");
 }
 
 // Function to print the game details in CSV format
@@ -223,6 +286,16 @@ bool Game::isUserSet() const
     return userSet;
 }
 
+// Getter for the oddsDirty flag
+/**
+ * @brief Checks if the home team odds are stale.
+ * @return True if the odds need to be recalculated, false otherwise.
+ */
+bool Game::isOddsDirty() const
+{
+    return oddsDirty;
+}
+
 // Setter for the home team score
 /**
  * @brief Sets the home team score.
@@ -261,6 +334,7 @@ void Game::setGameComplete(bool complete)
 void Game::setHomeTeamOdds(double odds)
 {
     homeTeamOdds = odds;
+    oddsDirty = false;
 }
 
 // Setter for the field advantage
@@ -293,6 +367,15 @@ void Game::setUserSet(bool isUserSet)
     userSet = isUserSet;
 }
 
+// Marks the odds as stale
+/**
+ * @brief Marks the home team odds as stale so they are recalculated before use.
+ */
+void Game::markOddsDirty()
+{
+    oddsDirty = true;
+}
+
 // Function to reset the game
 /**
  * @brief Resets the game.
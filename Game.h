@@ -2,21 +2,22 @@
 #define GAME_H
 
 #include <string>
-#include <unordered_map>
-#include <vector>
 #include <memory>
+#include "ReportWriter.h"
 #include "Team.h"
 
 class Game
 {
 public:
     // Constructors
-    Game(std::vector<std::string> tokens, const std::unordered_map<std::string, std::shared_ptr<Team>> &teamMapByAbbreviation);
+    Game(int week, const std::shared_ptr<Team> &home, const std::shared_ptr<Team> &away, bool complete, int homeScore, int awayScore);
+    Game(int week, const std::shared_ptr<Team> &team);
     Game(const std::shared_ptr<Team> &homeTeam, const std::shared_ptr<Team> &awayTeam);
+    Game(const Game &other, const std::shared_ptr<Team> &home, const std::shared_ptr<Team> &away);
     ~Game();
 
     // Getter functions
-    std::string getGameDetails(const std::shared_ptr<Team> &primaryTeam) const;
+    void writeGameDetails(ReportWriter &report, const Team &primary) const;
     std::string getCSVDetails(const std::shared_ptr<Team> &primaryTeam) const;
     std::shared_ptr<Team> getHomeTeam() const;
     std::shared_ptr<Team> getAwayTeam() const;
@@ -30,6 +31,7 @@ public:
     double getFieldAdvantage() const;
     double getEloRatingChange() const;
     bool isUserSet() const;
+    bool isOddsDirty() const;
 
     // Setter functions
     void setHomeTeamScore(int score);
@@ -39,6 +41,7 @@ public:
     void setFieldAdvantage(double advantage);
     void setEloRatingChange(double eloChange);
     void setUserSet(bool isUserSet);
+    void markOddsDirty();
     void resetGame();
 
 private:
@@ -46,13 +49,14 @@ private:
     std::shared_ptr<Team> awayTeam; // Away team
     bool byeWeek = false;           // Indicates if it's a bye week
     bool gameComplete = false;      // Indicates if the game is complete
-    int weekNumber;                 // Week number of the game
+    int weekNumber = 0;             // Week number of the game
     int homeTeamScore = 0;          // Score of the home team
     int awayTeamScore = 0;          // Score of the away team
     double homeTeamOdds;            // Odds for the home team
     double fieldAdvantage = -1;     // Field advantage value
     double eloRatingChange = 0;     // Change in Elo rating
-    bool userSet;                   // Indicates if the game result was set by the user
+    bool userSet = false;           // Indicates if the game result was set by the user
+    bool oddsDirty = false;         // Indicates if the odds are stale after an Elo change
 };
 
 #endif // GAME_H
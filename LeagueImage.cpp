@@ -0,0 +1,346 @@
+#include "LeagueImage.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Fingerprint.h"
+#include "Team.h"
+
+static_assert(std::is_trivially_copyable<LeagueImageTeam>::value && std::is_trivially_copyable<LeagueImageGame>::value,
+              "League image records are stored as raw bytes");
+
+// Identifies league image files
+static const char IMAGE_MAGIC[8] = {'N', 'F', 'L', 'L', 'E', 'A', 'G', '\0'};
+
+/**
+ * @brief Rounds a size up to the 8-byte alignment of the sections.
+ * @param size The size.
+ * @return The aligned size.
+ */
+static size_t alignSection(size_t size)
+{
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * @brief Copies a section into an image buffer.
+ * @param buffer The image buffer.
+ * @param offset The offset of the section.
+ * @param values The values of the section.
+ */
+template <typename T>
+static void copySection(std::string &buffer, size_t offset, const std::vector<T> &values)
+{
+    if (!values.empty())
+    {
+        std::memcpy(&buffer[offset], values.data(), values.size() * sizeof(T));
+    }
+}
+
+/**
+ * @brief Checks whether a fixed-size string field is terminated.
+ * @param field The field.
+ * @return True if the field holds a terminator.
+ */
+template <size_t N>
+static bool isTerminated(const char (&field)[N])
+{
+    return std::memchr(field, '\0', N) != nullptr;
+}
+
+/**
+ * @brief Checks whether a file starts like a league image.
+ * @param filename The file.
+ * @return True if the file starts with the league image magic.
+ */
+bool LeagueImage::isImage(const std::string &filename)
+{
+    // A raw read, since this runs on every start and a stream costs more than the rest of loading an image
+    char magic[sizeof(IMAGE_MAGIC)] = {};
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        return false;
+    }
+    bool image = read(descriptor, magic, sizeof(magic)) == static_cast<ssize_t>(sizeof(magic)) &&
+                 std::memcmp(magic, IMAGE_MAGIC, sizeof(magic)) == 0;
+    close(descriptor);
+    return image;
+}
+
+/**
+ * @brief Computes where the sections of an image start.
+ * @param numTeams The number of teams.
+ * @param numWeeks The number of weeks of every team's schedule row.
+ * @param numGames The number of games without byes.
+ * @return The section offsets and the size of the file.
+ */
+LeagueImage::Layout LeagueImage::computeLayout(uint32_t numTeams, uint32_t numWeeks, uint32_t numGames)
+{
+    Layout sections;
+    sections.teams = alignSection(sizeof(LeagueImageHeader));
+    sections.games = alignSection(sections.teams + numTeams * sizeof(LeagueImageTeam));
+    sections.teamGameIds = alignSection(sections.games + numGames * sizeof(LeagueImageGame));
+    sections.restAdjustments = alignSection(sections.teamGameIds + static_cast<size_t>(numTeams) * numWeeks * sizeof(int16_t));
+    sections.travelAdvantage = alignSection(sections.restAdjustments + numGames * sizeof(double));
+    sections.scoreThresholds = alignSection(sections.travelAdvantage + static_cast<size_t>(numTeams) * numTeams * sizeof(double));
+    sections.scoreGuide = alignSection(sections.scoreThresholds + NUM_SCORE_THRESHOLDS * sizeof(double));
+    sections.marginLogarithms = alignSection(sections.scoreGuide + SCORE_GUIDE_SLICES * sizeof(uint8_t));
+    sections.checksum = alignSection(sections.marginLogarithms + NUM_MARGIN_LOGARITHMS * sizeof(double));
+    sections.size = sections.checksum + sizeof(uint64_t);
+    return sections;
+}
+
+/**
+ * @brief Lays out, checksums and writes a league image.
+ *
+ * The image is written to a temporary file first and renamed over the old one, so
+ * simulators mapping the old image never see a partly written file.
+ *
+ * @param filename The image file.
+ * @param image The contents of the image.
+ * @return False if the contents do not match their counts or the file could not be written.
+ */
+bool LeagueImage::save(const std::string &filename, const LeagueImageContents &image)
+{
+    const size_t numTeams = image.teams.size();
+    const size_t numWeeks = static_cast<size_t>(image.numWeeks);
+    const size_t numGames = image.games.size();
+    if (image.teamGameIds.size() != numTeams * numWeeks || image.restAdjustments.size() != numGames ||
+        image.travelAdvantage.size() != numTeams * numTeams || image.scoreThresholds.size() != NUM_SCORE_THRESHOLDS ||
+        image.scoreGuide.size() != SCORE_GUIDE_SLICES || image.marginLogarithms.size() != NUM_MARGIN_LOGARITHMS)
+    {
+        std::cerr << "Error: League image sections do not match the league" << std::endl;
+        return false;
+    }
+
+    Layout sections = computeLayout(static_cast<uint32_t>(numTeams), static_cast<uint32_t>(numWeeks), static_cast<uint32_t>(numGames));
+    std::string buffer(sections.size, '\0');
+
+    LeagueImageHeader imageHeader{};
+    std::memcpy(imageHeader.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    imageHeader.version = VERSION;
+    imageHeader.numTeams = static_cast<uint32_t>(numTeams);
+    imageHeader.numWeeks = static_cast<uint32_t>(numWeeks);
+    imageHeader.numGames = static_cast<uint32_t>(numGames);
+    imageHeader.size = sections.size;
+    imageHeader.modelFingerprint = image.modelFingerprint;
+    std::memcpy(&buffer[0], &imageHeader, sizeof(imageHeader));
+
+    copySection(buffer, sections.teams, image.teams);
+    copySection(buffer, sections.games, image.games);
+    copySection(buffer, sections.teamGameIds, image.teamGameIds);
+    copySection(buffer, sections.restAdjustments, image.restAdjustments);
+    copySection(buffer, sections.travelAdvantage, image.travelAdvantage);
+    copySection(buffer, sections.scoreThresholds, image.scoreThresholds);
+    copySection(buffer, sections.scoreGuide, image.scoreGuide);
+    copySection(buffer, sections.marginLogarithms, image.marginLogarithms);
+
+    std::vector<uint64_t> words(sections.checksum / sizeof(uint64_t));
+    std::memcpy(words.data(), buffer.data(), sections.checksum);
+    Fingerprint checksum;
+    checksum.addWords(words.data(), words.size());
+    std::memcpy(&buffer[sections.checksum], &checksum.hash, sizeof(checksum.hash));
+
+    std::string tempFilename = filename + ".tmp";
+    std::ofstream out(tempFilename, std::ios::binary | std::ios::trunc);
+    if (!out.write(buffer.data(), static_cast<std::streamsize>(buffer.size())) || !out.flush())
+    {
+        std::cerr << "Error: Could not write league image " << tempFilename << std::endl;
+        return false;
+    }
+    out.close();
+
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::cerr << "Error: Could not replace league image " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Maps an image and checks that it is complete and consistent.
+ * @param filename The image file.
+ * @return False if the file is missing, truncated, corrupt or from another build.
+ */
+bool LeagueImage::open(const std::string &filename)
+{
+    if (!file.open(filename))
+    {
+        return false;
+    }
+    contents = file.data();
+
+    if (file.size() < sizeof(LeagueImageHeader) || std::memcmp(header().magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 ||
+        header().version != VERSION)
+    {
+        std::cerr << "Error: " << filename << " is not a league image of this build" << std::endl;
+        return false;
+    }
+
+    if (header().numTeams == 0 || header().numTeams > MAX_TEAMS || header().numWeeks > UINT8_MAX ||
+        header().numGames > INT16_MAX || header().size != file.size())
+    {
+        std::cerr << "Error: League image " << filename << " is truncated or malformed" << std::endl;
+        return false;
+    }
+
+    layout = computeLayout(header().numTeams, header().numWeeks, header().numGames);
+    if (layout.size != file.size())
+    {
+        std::cerr << "Error: League image " << filename << " is truncated or malformed" << std::endl;
+        return false;
+    }
+
+    // The mapping is page aligned and the checksum offset a multiple of 8
+    Fingerprint checksum;
+    checksum.addWords(reinterpret_cast<const uint64_t *>(contents), layout.checksum / sizeof(uint64_t));
+    uint64_t storedChecksum;
+    std::memcpy(&storedChecksum, contents + layout.checksum, sizeof(storedChecksum));
+    if (storedChecksum != checksum.hash)
+    {
+        std::cerr << "Error: League image " << filename << " is corrupt" << std::endl;
+        return false;
+    }
+
+    return validate(filename);
+}
+
+/**
+ * @brief Checks that every index in an opened image is in range and that the team
+ *        schedules agree with the game table.
+ * @param filename The image file, for the error message.
+ * @return False if the image is inconsistent.
+ */
+bool LeagueImage::validate(const std::string &filename) const
+{
+    const uint32_t numTeams = header().numTeams;
+    const uint32_t numWeeks = header().numWeeks;
+    const uint32_t numGames = header().numGames;
+    bool valid = true;
+
+    for (uint32_t team = 0; team < numTeams && valid; ++team)
+    {
+        const LeagueImageTeam &record = teams()[team];
+        valid = isTerminated(record.name) && isTerminated(record.abbreviation) && isTerminated(record.color) &&
+                isTerminated(record.city) && isTerminated(record.conference) && isTerminated(record.division);
+    }
+
+    for (uint32_t gameId = 0; gameId < numGames && valid; ++gameId)
+    {
+        const LeagueImageGame &game = games()[gameId];
+        valid = game.home < numTeams && game.away < numTeams && game.home != game.away && game.week < numWeeks &&
+                (gameId == 0 || games()[gameId - 1].week <= game.week);
+    }
+
+    for (uint32_t team = 0; team < numTeams && valid; ++team)
+    {
+        for (uint32_t week = 0; week < numWeeks && valid; ++week)
+        {
+            int gameId = teamGameIds()[team * numWeeks + week];
+            if (gameId >= 0)
+            {
+                valid = static_cast<uint32_t>(gameId) < numGames && games()[gameId].week == week &&
+                        (games()[gameId].home == team || games()[gameId].away == team);
+            }
+            else
+            {
+                valid = gameId == -1;
+            }
+        }
+    }
+
+    if (!valid)
+    {
+        std::cerr << "Error: League image " << filename << " is inconsistent" << std::endl;
+    }
+    return valid;
+}
+
+/**
+ * @brief Gets the header of the image.
+ * @return The header.
+ */
+const LeagueImageHeader &LeagueImage::header() const
+{
+    return *reinterpret_cast<const LeagueImageHeader *>(contents);
+}
+
+/**
+ * @brief Gets the teams, in schedule index order.
+ * @return The start of the section.
+ */
+const LeagueImageTeam *LeagueImage::teams() const
+{
+    return reinterpret_cast<const LeagueImageTeam *>(contents + layout.teams);
+}
+
+/**
+ * @brief Gets the games, in chronological order.
+ * @return The start of the section.
+ */
+const LeagueImageGame *LeagueImage::games() const
+{
+    return reinterpret_cast<const LeagueImageGame *>(contents + layout.games);
+}
+
+/**
+ * @brief Gets the game id per team and week, -1 for byes.
+ * @return The start of the section.
+ */
+const int16_t *LeagueImage::teamGameIds() const
+{
+    return reinterpret_cast<const int16_t *>(contents + layout.teamGameIds);
+}
+
+/**
+ * @brief Gets the bye week Elo points per game.
+ * @return The start of the section.
+ */
+const double *LeagueImage::restAdjustments() const
+{
+    return reinterpret_cast<const double *>(contents + layout.restAdjustments);
+}
+
+/**
+ * @brief Gets the home field and travel Elo points per home/away pair.
+ * @return The start of the section.
+ */
+const double *LeagueImage::travelAdvantage() const
+{
+    return reinterpret_cast<const double *>(contents + layout.travelAdvantage);
+}
+
+/**
+ * @brief Gets the probability of a regular season score below 1, 2, ....
+ * @return The start of the section.
+ */
+const double *LeagueImage::scoreThresholds() const
+{
+    return reinterpret_cast<const double *>(contents + layout.scoreThresholds);
+}
+
+/**
+ * @brief Gets the regular season score at the start of each slice of [0, 1).
+ * @return The start of the section.
+ */
+const uint8_t *LeagueImage::scoreGuide() const
+{
+    return reinterpret_cast<const uint8_t *>(contents + layout.scoreGuide);
+}
+
+/**
+ * @brief Gets the ln(d + 1) per point difference d.
+ * @return The start of the section.
+ */
+const double *LeagueImage::marginLogarithms() const
+{
+    return reinterpret_cast<const double *>(contents + layout.marginLogarithms);
+}
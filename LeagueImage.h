@@ -0,0 +1,141 @@
+#ifndef LEAGUEIMAGE_H
+#define LEAGUEIMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+// Sizes of the score tables the simulation draws regular season scores from
+constexpr int NUM_SCORE_THRESHOLDS = 255;  // Scores with a threshold, the highest drawable score
+constexpr int SCORE_GUIDE_SLICES = 4096;   // Equal slices of [0, 1) with a starting score
+constexpr int NUM_MARGIN_LOGARITHMS = 512; // Point differences with a tabulated logarithm
+
+// Fixed-size header at the start of a league image
+struct LeagueImageHeader
+{
+    char magic[8];             // "NFLLEAG" and a terminator
+    uint32_t version;          // LeagueImage::VERSION of the writer
+    uint32_t numTeams;         // Teams, in schedule index order
+    uint32_t numWeeks;         // Weeks of every team's schedule row, byes included
+    uint32_t numGames;         // Games without byes, in chronological order
+    uint64_t size;             // Size of the whole file, checksum included
+    uint64_t modelFingerprint; // Hash of the odds and score tables, as the simulator computes it
+};
+
+// A team with its preseason and current Elo rating
+struct LeagueImageTeam
+{
+    char name[48];
+    char abbreviation[8];
+    char color[16];
+    char city[32];
+    char conference[16];
+    char division[16];
+    double preseasonElo; // Elo rating before any result
+    double elo;          // Elo rating after the completed games
+    double latitude;
+    double longitude;
+};
+
+// A game of the deduplicated game table
+struct LeagueImageGame
+{
+    double eloRatingChange; // Elo points the home team gained from the result, 0 if not played
+    int16_t homeScore;
+    int16_t awayScore;
+    uint8_t home;     // Schedule index of the home team
+    uint8_t away;     // Schedule index of the away team
+    uint8_t week;     // Week of the game (0-based)
+    uint8_t complete; // 1 if the result is known
+};
+
+/**
+ * @brief Stores a string in a fixed-size field of a league image record.
+ * @param field The field, filled with terminators after the string.
+ * @param value The string.
+ * @return False if the string does not fit with its terminator.
+ */
+template <size_t N>
+bool setImageString(char (&field)[N], const std::string &value)
+{
+    if (value.size() >= N)
+    {
+        return false;
+    }
+    std::memset(field, 0, N);
+    std::memcpy(field, value.data(), value.size());
+    return true;
+}
+
+// Contents of a league image to be written
+struct LeagueImageContents
+{
+    int numWeeks = 0;
+    uint64_t modelFingerprint = 0;
+    std::vector<LeagueImageTeam> teams;
+    std::vector<LeagueImageGame> games;
+    std::vector<int16_t> teamGameIds;
+    std::vector<double> restAdjustments;
+    std::vector<double> travelAdvantage;
+    std::vector<double> scoreThresholds;
+    std::vector<uint8_t> scoreGuide;
+    std::vector<double> marginLogarithms;
+};
+
+// Compiled league: teams, games, completed results and the precomputed Elo state
+// and odds tables, so a simulator can start from it without parsing or replaying
+// anything. The file is the header, the sections below each aligned to 8 bytes, and
+// a word-wise FNV-1a checksum of everything before it:
+//
+//   teams             LeagueImageTeam[numTeams]
+//   games             LeagueImageGame[numGames]
+//   teamGameIds       int16_t[numTeams * numWeeks], game id per team and week, -1 for byes
+//   restAdjustments   double[numGames], bye week Elo points per game
+//   travelAdvantage   double[numTeams * numTeams], home field and travel Elo points per home/away pair
+//   scoreThresholds   double[NUM_SCORE_THRESHOLDS]
+//   scoreGuide        uint8_t[SCORE_GUIDE_SLICES]
+//   marginLogarithms  double[NUM_MARGIN_LOGARITHMS]
+//
+// An opened image is read in place from a memory mapping. Like checkpoints, images
+// are only meant for the build and machine that wrote them.
+class LeagueImage
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    static bool isImage(const std::string &filename);
+    static bool save(const std::string &filename, const LeagueImageContents &image);
+
+    bool open(const std::string &filename);
+
+    const LeagueImageHeader &header() const;
+    const LeagueImageTeam *teams() const;
+    const LeagueImageGame *games() const;
+    const int16_t *teamGameIds() const;
+    const double *restAdjustments() const;
+    const double *travelAdvantage() const;
+    const double *scoreThresholds() const;
+    const uint8_t *scoreGuide() const;
+    const double *marginLogarithms() const;
+
+private:
+    // Offsets of the sections for the counts of a header
+    struct Layout
+    {
+        size_t teams, games, teamGameIds, restAdjustments, travelAdvantage;
+        size_t scoreThresholds, scoreGuide, marginLogarithms, checksum, size;
+    };
+
+    static Layout computeLayout(uint32_t numTeams, uint32_t numWeeks, uint32_t numGames);
+    bool validate(const std::string &filename) const;
+
+    MappedFile file;                // Mapping of the image
+    const char *contents = nullptr; // Start of the mapping
+    Layout layout{};                // Offsets of the sections
+};
+
+#endif // LEAGUEIMAGE_H
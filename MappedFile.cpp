@@ -0,0 +1,85 @@
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructs a mapping with no file open.
+ */
+MappedFile::MappedFile() : contents(nullptr), length(0) {}
+
+/**
+ * @brief Unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+    if (contents)
+    {
+        munmap(const_cast<char *>(contents), length);
+    }
+}
+
+/**
+ * @brief Maps a file into memory for reading.
+ * @param path The file to map.
+ * @return False if the file could not be opened or mapped.
+ */
+bool MappedFile::open(const std::string &path)
+{
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        std::cerr << "Error: Could not open file " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) < 0)
+    {
+        std::cerr << "Error: Could not read file " << path << ": " << std::strerror(errno) << std::endl;
+        close(descriptor);
+        return false;
+    }
+
+    // An empty file cannot be mapped, but has no contents either
+    length = static_cast<size_t>(status.st_size);
+    if (length > 0)
+    {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            std::cerr << "Error: Could not map file " << path << ": " << std::strerror(errno) << std::endl;
+            close(descriptor);
+            length = 0;
+            return false;
+        }
+        madvise(mapping, length, MADV_SEQUENTIAL);
+        contents = static_cast<const char *>(mapping);
+    }
+    close(descriptor);
+    return true;
+}
+
+/**
+ * @brief Gets the contents of the file.
+ * @return The start of the mapping, nullptr for an empty file.
+ */
+const char *MappedFile::data() const
+{
+    return contents;
+}
+
+/**
+ * @brief Gets the size of the file.
+ * @return The size in bytes.
+ */
+size_t MappedFile::size() const
+{
+    return length;
+}
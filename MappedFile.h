@@ -0,0 +1,26 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file, unmapped when destroyed.
+// An empty file opens successfully with no contents.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    const char *data() const;
+    size_t size() const;
+
+private:
+    const char *contents; // Start of the mapping, nullptr for an empty file
+    size_t length;        // Size of the file
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,203 @@
+#include "MonteCarloEngine.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+/**
+ * @brief Constructs a MonteCarloEngine.
+ * @param threadCount The number of worker threads to use (at least one).
+ * @param seasonsPerBatch The number of seasons a worker takes from a queue at a time.
+ */
+MonteCarloEngine::MonteCarloEngine(int threadCount, int seasonsPerBatch)
+    : numThreads(std::max(1, threadCount)),
+      batchSize(std::max(1, seasonsPerBatch))
+{
+    for (int i = 0; i < numThreads; ++i)
+    {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+}
+
+MonteCarloEngine::~MonteCarloEngine() {}
+
+/**
+ * @brief Gets the number of worker threads.
+ * @return The number of worker threads.
+ */
+int MonteCarloEngine::getNumThreads() const
+{
+    return numThreads;
+}
+
+/**
+ * @brief Gets the number of seasons handed out per batch.
+ * @return The batch size.
+ */
+int MonteCarloEngine::getBatchSize() const
+{
+    return batchSize;
+}
+
+/**
+ * @brief Simulates seasons [0, numSeasons) across all worker threads.
+ *
+ * The season range is split evenly into one queue per worker. Worker 0 runs on
+ * the calling thread; the others are started here and joined before returning.
+ * An exception thrown by any batch is rethrown on the calling thread.
+ *
+ * @param numSeasons The number of seasons to simulate.
+ * @param processBatch The callback that simulates one batch of seasons.
+ */
+void MonteCarloEngine::run(int numSeasons, const BatchFunction &processBatch)
+{
+    if (numSeasons <= 0)
+    {
+        return;
+    }
+
+    // Hand every worker an equal, contiguous share of the seasons
+    for (int i = 0; i < numThreads; ++i)
+    {
+        queues[i]->begin = static_cast<int>(static_cast<long long>(numSeasons) * i / numThreads);
+        queues[i]->end = static_cast<int>(static_cast<long long>(numSeasons) * (i + 1) / numThreads);
+    }
+
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto guardedLoop = [&](int workerIndex)
+    {
+        try
+        {
+            workerLoop(workerIndex, processBatch);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure)
+            {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; ++i)
+    {
+        threads.emplace_back(guardedLoop, i);
+    }
+    guardedLoop(0);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
+
+/**
+ * @brief Takes the next batch from the front of a worker's own queue.
+ * @param workerIndex The worker whose queue is read.
+ * @param first Set to the first season of the batch.
+ * @param last Set to one past the last season of the batch.
+ * @return True if a batch was taken, false if the queue is empty.
+ */
+bool MonteCarloEngine::popBatch(int workerIndex, int &first, int &last)
+{
+    WorkQueue &queue = *queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.begin >= queue.end)
+    {
+        return false;
+    }
+
+    first = queue.begin;
+    last = std::min(queue.end, queue.begin + batchSize);
+    queue.begin = last;
+    return true;
+}
+
+/**
+ * @brief Steals work from the fullest queue of another worker.
+ *
+ * The thief takes the back half of the victim's remaining seasons, keeps them
+ * in its own queue and returns the first batch of them.
+ *
+ * @param workerIndex The worker that is out of work.
+ * @param first Set to the first season of the stolen batch.
+ * @param last Set to one past the last season of the stolen batch.
+ * @return True if work was stolen, false if every queue is empty.
+ */
+bool MonteCarloEngine::stealBatch(int workerIndex, int &first, int &last)
+{
+    while (true)
+    {
+        // Find the victim with the most remaining seasons
+        int victim = -1;
+        int mostRemaining = 0;
+        for (int i = 0; i < numThreads; ++i)
+        {
+            if (i == workerIndex)
+                continue;
+
+            std::lock_guard<std::mutex> lock(queues[i]->mutex);
+            int remaining = queues[i]->end - queues[i]->begin;
+            if (remaining > mostRemaining)
+            {
+                mostRemaining = remaining;
+                victim = i;
+            }
+        }
+
+        if (victim < 0)
+        {
+            return false;
+        }
+
+        int stolenBegin, stolenEnd;
+        {
+            WorkQueue &queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            int remaining = queue.end - queue.begin;
+            if (remaining <= 0)
+            {
+                continue; // The victim finished in the meantime; look again
+            }
+
+            // Leave the victim at least the batch it is about to take
+            int stolen = remaining > batchSize ? remaining / 2 : remaining;
+            stolenEnd = queue.end;
+            stolenBegin = queue.end - stolen;
+            queue.end = stolenBegin;
+        }
+
+        WorkQueue &own = *queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = stolenBegin;
+        own.end = stolenEnd;
+        first = own.begin;
+        last = std::min(own.end, own.begin + batchSize);
+        own.begin = last;
+        return true;
+    }
+}
+
+/**
+ * @brief Processes batches until neither the own queue nor any other queue has work left.
+ * @param workerIndex The index of the worker running the loop.
+ * @param processBatch The callback that simulates one batch of seasons.
+ */
+void MonteCarloEngine::workerLoop(int workerIndex, const BatchFunction &processBatch)
+{
+    int first, last;
+    while (popBatch(workerIndex, first, last) || stealBatch(workerIndex, first, last))
+    {
+        processBatch(workerIndex, first, last);
+    }
+}
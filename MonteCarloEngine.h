@@ -0,0 +1,48 @@
+#ifndef MONTECARLOENGINE_H
+#define MONTECARLOENGINE_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Distributes a range of season indices over a set of worker threads.
+// Each worker owns a queue of seasons and pulls fixed-size batches from
+// its front; once its own queue is drained it steals the back half of the
+// largest remaining queue, so uneven batches never leave a core idle.
+class MonteCarloEngine
+{
+public:
+    // Callback invoked for every batch: (workerIndex, firstSeason, lastSeason)
+    using BatchFunction = std::function<void(int, int, int)>;
+
+    // Constructors and Destructor
+    MonteCarloEngine(int threadCount, int seasonsPerBatch = 64);
+    ~MonteCarloEngine();
+
+    // Getter functions
+    int getNumThreads() const;
+    int getBatchSize() const;
+
+    // Runs seasons [0, numSeasons) and blocks until every batch has finished
+    void run(int numSeasons, const BatchFunction &processBatch);
+
+private:
+    // Per-worker queue of season indices, padded to its own cache line
+    struct alignas(64) WorkQueue
+    {
+        std::mutex mutex;
+        int begin = 0; // Next season to hand out from the front
+        int end = 0;   // One past the last season owned by this queue
+    };
+
+    bool popBatch(int workerIndex, int &first, int &last);
+    bool stealBatch(int workerIndex, int &first, int &last);
+    void workerLoop(int workerIndex, const BatchFunction &processBatch);
+
+    int numThreads;                                // Number of worker threads
+    int batchSize;                                 // Seasons handed out per batch
+    std::vector<std::unique_ptr<WorkQueue>> queues; // One queue per worker
+};
+
+#endif // MONTECARLOENGINE_H
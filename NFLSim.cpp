@@ -1,6 +1,23 @@
 
 #include "NFLSim.h"
 
+/**
+ * @brief Takes the settings of the runs from the command line options.
+ * @param options The command line options.
+ * @return The run settings, without an importance sampling target yet.
+ */
+static RunConfig runConfigFromOptions(const SimulationOptions &options)
+{
+    RunConfig config;
+    config.numThreads = options.numThreads > 0 ? options.numThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    config.seed = options.seed;
+    config.mathMode = options.mathMode;
+    config.antithetic = options.antithetic;
+    config.controlVariates = options.controlVariates;
+    config.setImportanceTilt(options.importanceTilt);
+    return config;
+}
+
 /**
  * @brief Constructor for the NFLSim class.
  *
@@ -8,24 +25,215 @@
  * reading the schedule from a file, processing all games, and running the simulation.
  *
  * @param scheduleFilename The filename of the schedule CSV file.
+ * @param options The command line options of the run.
+ */
+NFLSim::NFLSim(const std::string &scheduleFilename, const SimulationOptions &options)
+    : NFLSim(scheduleFilename, options, true)
+{
+}
+
+/**
+ * @brief Constructor that loads the league and optionally runs the simulation.
+ *
+ * The embeddable NFLSimulator loads the league without running anything and
+ * simulates seasons on request.
+ *
+ * @param scheduleFilename The filename of the schedule CSV file.
+ * @param options The options of the run.
+ * @param run Whether to run the simulation after loading.
  */
-NFLSim::NFLSim(const std::string &scheduleFilename)
+NFLSim::NFLSim(const std::string &scheduleFilename, const SimulationOptions &options, bool run)
+    : config(runConfigFromOptions(options)),
+      compareMath(options.compareMath),
+      checkpointFile(options.checkpointFile),
+      checkpointInterval(std::max(1, options.checkpointInterval)),
+      resumeFile(options.resumeFile),
+      showDistributions(options.showDistributions),
+      compactSchedule(options.compactSchedule),
+      distributionsFile(options.distributionsFile),
+      outputFile(options.outputFile),
+      failed(false),
+      modelFingerprint(0),
+      resultCache(std::make_shared<ResultCache>(std::max(0, options.cacheEntries), options.cacheDirectory)),
+      traceFile(options.traceFile),
+      traceColumns(options.traceColumns)
 {
-    // Read team data from a predefined CSV file
-    readTeams("static/preseason_nfl_teams.csv");
+    if (LeagueImage::isImage(scheduleFilename))
+    {
+        // A compiled league holds the teams, results and precomputed tables
+        if (!readLeagueImage(scheduleFilename))
+        {
+            failed = true;
+            return;
+        }
+    }
+    else
+    {
+        // Read team data, by default from the predefined CSV file
+        if (!readTeams(options.teamsFile) || teamMapByAbbreviation.empty())
+        {
+            failed = true;
+            return;
+        }
+
+        // Precompute the score distribution, which the Elo updates of completed games use
+        buildScoreTable();
+
+        // Read the schedule from the provided filename
+        if (!readSchedule(scheduleFilename))
+        {
+            failed = true;
+            return;
+        }
 
-    // Read the schedule from the provided filename
-    readSchedule(scheduleFilename);
+        // Precompute the travel and rest adjustments of the odds
+        buildAdjustmentTables();
+        buildModelFingerprint();
+    }
 
     // Process all games to calculate initial odds and Elo ratings
     processAllGames();
 
-    // Run the simulation
-    runSimulation();
+    // Index teams and conferences for the season states
+    buildSeasonLayout();
+    buildSeasonResults();
+    if (teamsByIndex.empty() || seasonGames.empty())
+    {
+        std::cerr << "Error: No games were loaded from " << scheduleFilename << std::endl;
+        failed = true;
+        return;
+    }
+
+    // Resolve the importance sampling target
+    if (!options.importanceTarget.empty())
+    {
+        auto target = teamMapByAbbreviation.find(options.importanceTarget);
+        if (target == teamMapByAbbreviation.end())
+        {
+            std::cerr << "Error: Unknown importance sampling target: " << options.importanceTarget << std::endl;
+            failed = true;
+            return;
+        }
+        config.importanceTeam = target->second->getScheduleIndex();
+    }
+
+    // Compile the league, resume a saved run, run headless, or let the user drive the simulation
+    if (!run)
+    {
+        return;
+    }
+    else if (!options.compileFile.empty())
+    {
+        failed = !compileLeague(options.compileFile);
+    }
+    else if (!resumeFile.empty())
+    {
+        resumeRun();
+    }
+    else if (options.batchSeasons > 0 && compareMath)
+    {
+        failed = !compareMathModes(options.batchSeasons);
+    }
+    else if (options.batchSeasons > 0)
+    {
+        simulateMultipleSeasons(options.batchSeasons, false);
+    }
+    else
+    {
+        runSimulation();
+    }
+}
+
+/**
+ * @brief Copy constructor that deep-copies the league.
+ *
+ * Every team and game is duplicated and the copies are wired to each other, so
+ * simulated seasons can be copied into the new object without touching the original.
+ * Games shared between two schedule rows stay shared in the copy.
+ *
+ * @param other The simulation to copy.
+ */
+NFLSim::NFLSim(const NFLSim &other)
+    : preseasonElo(other.preseasonElo),
+      travelAdvantage(other.travelAdvantage),
+      gameRestAdjustment(other.gameRestAdjustment),
+      scoreThresholds(other.scoreThresholds),
+      scoreGuide(other.scoreGuide),
+      marginLogarithms(other.marginLogarithms),
+      config(other.config),
+      compareMath(false),
+      checkpointInterval(other.checkpointInterval),
+      showDistributions(false),
+      compactSchedule(other.compactSchedule),
+      failed(false),
+      modelFingerprint(other.modelFingerprint),
+      resultCache(other.resultCache),
+      traceColumns(other.traceColumns)
+{
+    // Copies only serve as print views, which simulate on one thread
+    config.numThreads = 1;
+
+    // Copy every team and remember which copy belongs to which original
+    std::unordered_map<const Team *, std::shared_ptr<Team>> teamCopies;
+    for (const auto &teamPair : other.teamMapByAbbreviation)
+    {
+        auto team = std::make_shared<Team>(*teamPair.second);
+        teamCopies[teamPair.second.get()] = team;
+        teamMapByAbbreviation[teamPair.first] = team;
+    }
+
+    // Rebuild the league structure from the copied teams
+    for (const auto &conferencePair : other.leagueStructure)
+    {
+        for (const auto &divisionPair : conferencePair.second)
+        {
+            auto &division = leagueStructure[conferencePair.first][divisionPair.first];
+            for (const auto &team : divisionPair.second)
+            {
+                division.push_back(teamCopies.at(team.get()));
+            }
+        }
+    }
+
+    // Copy each game once, even though it appears in both teams' schedules
+    std::unordered_map<const Game *, std::shared_ptr<Game>> gameCopies;
+    for (const auto &teamSchedule : other.NFLSchedule)
+    {
+        std::vector<std::shared_ptr<Game>> schedule;
+        for (const auto &game : teamSchedule)
+        {
+            auto &copy = gameCopies[game.get()];
+            if (!copy)
+            {
+                copy = std::make_shared<Game>(*game,
+                                              teamCopies.at(game->getHomeTeam().get()),
+                                              teamCopies.at(game->getAwayTeam().get()));
+            }
+            schedule.push_back(copy);
+        }
+        NFLSchedule.push_back(schedule);
+    }
+
+    for (const auto &game : other.seasonGames)
+    {
+        seasonGames.push_back(gameCopies.at(game.get()));
+    }
+    buildGameIndex();
+    buildSeasonLayout();
+    buildSeasonResults();
 }
 
 NFLSim::~NFLSim() {}
 
+/**
+ * @brief Reports whether loading the league or a headless run failed.
+ * @return True if an error was reported.
+ */
+bool NFLSim::hasFailed() const
+{
+    return failed;
+}
+
 /**
  * @brief Runs the main simulation loop, allowing user interaction.
  *
@@ -92,73 +300,249 @@ void NFLSim::runSimulation()
     {
         handleRunCommand(false);
     }
+
+    std::cout << "Do you want to evaluate what-if scenarios? (yes/no): ";
+    while (std::getline(std::cin, command) && command != "yes" && command != "no")
+    {
+        std::cout << "Unknown command. Please enter 'yes' or 'no': ";
+    }
+
+    if (command == "yes")
+    {
+        evaluateWhatIfs();
+    }
 }
 
 /**
  * @brief Handles the "run" command to simulate multiple seasons.
  *
  * This function prompts the user to enter the number of seasons to simulate and then runs the simulation for that many seasons.
+ * Entering "auto" instead asks for a target confidence half-width and simulates until every playoff
+ * probability is that precise; schedules are not printed in that mode.
  */
 void NFLSim::handleRunCommand(bool print)
 {
-    int numSeasons;
-    std::cout << "Enter number of seasons to simulate: ";
-    std::cin >> numSeasons;
+    std::string input;
+    std::cout << "Enter number of seasons to simulate, or 'auto' to run until every playoff probability is precise: ";
+    std::cin >> input;
+
+    if (input == "auto")
+    {
+        double targetHalfWidth;
+        std::cout << "Enter the target 95% confidence half-width in percentage points (e.g. 0.25): ";
+        std::cin >> targetHalfWidth;
+        std::cin.ignore(); // Ignore newline character left in the input buffer
+
+        if (!std::cin || targetHalfWidth <= 0.0)
+        {
+            std::cerr << "Error: The half-width must be a positive number." << std::endl;
+            return;
+        }
+        simulateUntilConfident(targetHalfWidth / 100.0);
+        return;
+    }
     std::cin.ignore(); // Ignore newline character left in the input buffer
+
+    int numSeasons;
+    try
+    {
+        numSeasons = std::stoi(input);
+    }
+    catch (const std::exception &)
+    {
+        std::cerr << "Error: Invalid number of seasons: " << input << std::endl;
+        return;
+    }
+
+    if (compareMath)
+    {
+        compareMathModes(numSeasons);
+        return;
+    }
     simulateMultipleSeasons(numSeasons, print);
 }
 
+/**
+ * @brief Simulates what-if scenarios on top of the current schedule.
+ *
+ * Each scenario forks a snapshot of the current results and sets the scenario's results
+ * in the fork only, so the schedule and the other scenarios are left untouched. Every
+ * scenario replays the same random streams, so differences between scenarios come from
+ * the results set rather than from sampling noise.
+ */
+void NFLSim::evaluateWhatIfs()
+{
+    const SeasonSnapshot base = takeSnapshot();
+    std::string line;
+
+    while (true)
+    {
+        std::cout << "Enter what-if results as 'TEAM WEEK HOME-AWAY' separated by ';', or 'done': ";
+        if (!std::getline(std::cin, line) || line == "done")
+        {
+            break;
+        }
+
+        // Set every result of the scenario in a fork of the snapshot
+        SeasonSnapshot branch = base.fork();
+        bool valid = true;
+        std::stringstream results(line);
+        std::string result;
+        while (valid && std::getline(results, result, ';'))
+        {
+            std::stringstream fields(result);
+            std::string abbreviation;
+            int week, homeScore, awayScore;
+            char dash;
+            if (!(fields >> abbreviation >> week >> homeScore >> dash >> awayScore) || dash != '-')
+            {
+                std::cerr << "Error: Invalid what-if result: " << result << std::endl;
+                valid = false;
+                break;
+            }
+
+            auto team = teamMapByAbbreviation.find(abbreviation);
+            if (team == teamMapByAbbreviation.end())
+            {
+                std::cerr << "Error: Unknown team: " << abbreviation << std::endl;
+                valid = false;
+            }
+            else if (!setSnapshotResult(branch, team->second->getScheduleIndex(), week, homeScore, awayScore))
+            {
+                std::cerr << "Error: " << abbreviation << " has no game in week " << week << std::endl;
+                valid = false;
+            }
+        }
+
+        if (!valid)
+        {
+            continue;
+        }
+
+        int numSeasons;
+        std::cout << "Enter number of seasons to simulate: ";
+        if (!(std::cin >> numSeasons) || numSeasons <= 0)
+        {
+            std::cerr << "Error: The number of seasons must be a positive number." << std::endl;
+            std::cin.clear();
+        }
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (numSeasons <= 0)
+        {
+            continue;
+        }
+
+        SeasonTally tally = runSeasons(buildSeasonState(branch), 0, numSeasons, false);
+        std::cout << "What-if: " << line << std::endl;
+        printFinalResults(tally, false, std::cout);
+    }
+}
+
 /**
  * @brief Reads the schedule from a CSV file and populates the NFLSchedule.
  *
- * This function reads the schedule from the provided CSV file, processes each line to extract game information,
- * and creates Game objects for each game. It updates the NFLSchedule with the parsed game data.
+ * This function maps the provided CSV file, parses each team's row of games in place and
+ * creates Game objects for each game. It updates the NFLSchedule with the parsed game data and
+ * builds the deduplicated, week-ordered game index the simulation iterates. Each game is written
+ * as OPPONENT#COMPLETE#HOME_SCORE#AWAY_SCORE, with an '@' before away opponents, or as BYE.
  *
  * @param filename The name of the CSV file containing the schedule.
+ * @return False if the file could not be read or is malformed; the error is printed with its line and column.
  */
-void NFLSim::readSchedule(const std::string &filename)
+bool NFLSim::readSchedule(const std::string &filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    CsvReader reader;
+    if (!reader.open(filename))
     {
-        std::cerr << "Error opening file: " << filename << std::endl;
-        return;
+        return false;
     }
 
-    std::string line;
-    std::getline(file, line); // Skip the first line (header)
+    // Keep the preseason ratings so snapshots can replay the results from scratch
+    for (const auto &teamPair : teamMapByAbbreviation)
+    {
+        preseasonElo[teamPair.second->getScheduleIndex()] = teamPair.second->getEloRating();
+    }
+
+    reader.nextRow(); // Skip the first line (header)
 
     // Read each line of the file
-    while (std::getline(file, line))
+    std::string_view field;
+    while (reader.nextRow())
     {
-        std::stringstream ss(line);
-        std::string teamName;
-        std::getline(ss, teamName, ','); // Read team name
+        reader.nextField(field);
+        auto team = findTeam(field);
+        if (!team)
+        {
+            std::cerr << "Error: " << reader.location(field) << ": unknown team '" << field << "'" << std::endl;
+            return false;
+        }
 
         std::vector<std::shared_ptr<Game>> teamSchedule; // Vector to hold game pointers for the team
-        std::string gameInfo;
-        int week = 0; // Start week counter
+        int week = 0;                                    // Start week counter
 
         // Read each game information for the team
-        while (std::getline(ss, gameInfo, ','))
+        while (reader.nextField(field))
         {
-            // Process the game information and create a new Game object wrapped in a shared_ptr
-            std::vector<std::string> tokens = parseGameInfo(teamName, gameInfo, week);
-            auto newGame = std::make_shared<Game>(tokens, teamMapByAbbreviation);
+            std::string_view rest = field;
+            std::string_view opponentToken = nextToken(rest, '#');
+            std::string_view completeToken = nextToken(rest, '#');
+            std::string_view homeScoreToken = nextToken(rest, '#');
+            std::string_view awayScoreToken = nextToken(rest, '#');
+
+            std::shared_ptr<Game> newGame;
+            if (opponentToken == "BYE")
+            {
+                newGame = std::make_shared<Game>(week, team);
+            }
+            else
+            {
+                bool away = !opponentToken.empty() && opponentToken[0] == '@';
+                std::string_view abbreviation = away ? opponentToken.substr(1) : opponentToken;
+                auto opponent = findTeam(abbreviation);
+                if (!opponent)
+                {
+                    std::cerr << "Error: " << reader.location(opponentToken) << ": unknown opponent '" << opponentToken << "'" << std::endl;
+                    return false;
+                }
+                if (completeToken != "Y" && completeToken != "N")
+                {
+                    std::cerr << "Error: " << reader.location(completeToken) << ": expected Y or N, got '" << completeToken << "'" << std::endl;
+                    return false;
+                }
+
+                int homeScore, awayScore;
+                if (!parseField(homeScoreToken, homeScore) || homeScore < 0)
+                {
+                    std::cerr << "Error: " << reader.location(homeScoreToken) << ": invalid home score '" << homeScoreToken << "'" << std::endl;
+                    return false;
+                }
+                if (!parseField(awayScoreToken, awayScore) || awayScore < 0 || !rest.empty())
+                {
+                    std::cerr << "Error: " << reader.location(awayScoreToken) << ": invalid away score '" << awayScoreToken << "'" << std::endl;
+                    return false;
+                }
+
+                newGame = std::make_shared<Game>(week, away ? opponent : team, away ? team : opponent,
+                                                 completeToken == "Y", homeScore, awayScore);
+            }
 
             // Check if the game object already exists, if it does push existing object again
             int minScheduleIdx = std::min(newGame->getHomeTeam()->getScheduleIndex(), newGame->getAwayTeam()->getScheduleIndex());
             if (minScheduleIdx < static_cast<int>(NFLSchedule.size()))
             {
+                if (week >= static_cast<int>(NFLSchedule[minScheduleIdx].size()))
+                {
+                    std::cerr << "Error: " << reader.location(field) << ": game is missing from the opponent's row" << std::endl;
+                    return false;
+                }
                 teamSchedule.push_back(NFLSchedule[minScheduleIdx][week]);
             }
             else
             {
                 teamSchedule.push_back(newGame);
-                // Update Elos if game was completed in csv file
-                if (newGame->isGameComplete())
+                if (!newGame->isByeWeek())
                 {
-                    updateEloRatings(newGame);
+                    seasonGames.push_back(newGame);
                 }
             }
 
@@ -168,121 +552,293 @@ void NFLSim::readSchedule(const std::string &filename)
         NFLSchedule.push_back(teamSchedule); // Add the team's schedule to NFLSchedule
     }
 
-    file.close();
+    // Index every game once, in chronological order
+    buildGameIndex();
+
+    // Update Elos of the games completed in the csv file, in the order they were played
+    for (auto &game : seasonGames)
+    {
+        if (game->isGameComplete())
+        {
+            updateEloRatings(game);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Looks up a team by its abbreviation.
+ * @param abbreviation The abbreviation, as read from a file.
+ * @return The team, or nullptr if there is none.
+ */
+std::shared_ptr<Team> NFLSim::findTeam(std::string_view abbreviation) const
+{
+    // Abbreviations fit in the short string buffer, so the key allocates nothing
+    auto teamIt = teamMapByAbbreviation.find(std::string(abbreviation));
+    return teamIt == teamMapByAbbreviation.end() ? nullptr : teamIt->second;
 }
 
 /**
- * @brief Parses game information for a specific team and week.
+ * @brief Loads a compiled league image instead of the team and schedule CSV files.
  *
- * This function takes a team's name, game information string, and the week number,
- * and parses the game information to extract relevant details such as the week number,
- * home team, and away team. It returns a vector of strings containing the parsed information.
+ * The teams, games and completed results are rebuilt from the image together with the
+ * Elo ratings after those results, the game index, the precomputed odds tables and
+ * their fingerprint, so nothing is parsed, replayed or hashed again.
  *
- * @param teamName The name of the team.
- * @param gameInfo The game information string.
- * @param week The week number.
- * @return A vector of strings containing the parsed game information.
+ * @param filename The league image written by compileLeague.
+ * @return False if the image could not be mapped or is invalid.
+ */
+bool NFLSim::readLeagueImage(const std::string &filename)
+{
+    LeagueImage image;
+    if (!image.open(filename))
+    {
+        return false;
+    }
+
+    const int numTeams = static_cast<int>(image.header().numTeams);
+    const int numWeeks = static_cast<int>(image.header().numWeeks);
+    const int numGames = static_cast<int>(image.header().numGames);
+
+    // Teams, with the Elo ratings they had after the completed games
+    std::vector<std::shared_ptr<Team>> teams;
+    for (int teamIndex = 0; teamIndex < numTeams; ++teamIndex)
+    {
+        const LeagueImageTeam &record = image.teams()[teamIndex];
+        auto team = std::make_shared<Team>(record.name, record.abbreviation, record.color, record.preseasonElo,
+                                           record.city, record.latitude, record.longitude, teamIndex);
+        team->setEloRating(record.elo);
+        preseasonElo[teamIndex] = record.preseasonElo;
+        teamMapByAbbreviation[record.abbreviation] = team;
+        leagueStructure[record.conference][record.division].push_back(team);
+        teams.push_back(team);
+    }
+
+    // Games, already in chronological order
+    const double *travel = image.travelAdvantage();
+    int lastWeek = numGames > 0 ? image.games()[numGames - 1].week : -1;
+    weekGameOffsets.assign(lastWeek + 2, 0);
+    for (int gameId = 0; gameId < numGames; ++gameId)
+    {
+        const LeagueImageGame &record = image.games()[gameId];
+        auto game = std::make_shared<Game>(record.week, teams[record.home], teams[record.away],
+                                           record.complete != 0, record.homeScore, record.awayScore);
+        game->setEloRatingChange(record.eloRatingChange);
+        game->setFieldAdvantage(travel[record.home * numTeams + record.away]);
+        seasonGames.push_back(game);
+        ++weekGameOffsets[record.week + 1];
+    }
+    std::partial_sum(weekGameOffsets.begin(), weekGameOffsets.end(), weekGameOffsets.begin());
+
+    // Each team's weekly schedule, sharing the games with their opponents
+    teamGameIds.assign(numTeams, std::vector<int>(numWeeks));
+    NFLSchedule.assign(numTeams, {});
+    for (int teamIndex = 0; teamIndex < numTeams; ++teamIndex)
+    {
+        for (int week = 0; week < numWeeks; ++week)
+        {
+            int gameId = image.teamGameIds()[teamIndex * numWeeks + week];
+            teamGameIds[teamIndex][week] = gameId;
+            NFLSchedule[teamIndex].push_back(gameId < 0 ? std::make_shared<Game>(week, teams[teamIndex]) : seasonGames[gameId]);
+        }
+    }
+
+    // Precomputed odds and score tables
+    for (int homeIndex = 0; homeIndex < numTeams; ++homeIndex)
+    {
+        std::copy(travel + homeIndex * numTeams, travel + (homeIndex + 1) * numTeams, travelAdvantage[homeIndex].begin());
+    }
+    gameRestAdjustment.assign(image.restAdjustments(), image.restAdjustments() + numGames);
+    std::copy(image.scoreThresholds(), image.scoreThresholds() + NUM_SCORE_THRESHOLDS, scoreThresholds.begin());
+    std::copy(image.scoreGuide(), image.scoreGuide() + SCORE_GUIDE_SLICES, scoreGuide.begin());
+    std::copy(image.marginLogarithms(), image.marginLogarithms() + NUM_MARGIN_LOGARITHMS, marginLogarithms.begin());
+    // Rehashed rather than taken from the header, so images of an older model version get a new fingerprint
+    buildModelFingerprint();
+    return true;
+}
+
+/**
+ * @brief Compiles the loaded league into an image that later runs load without parsing.
+ * @param filename The image file to write.
+ * @return False if the league cannot be stored in an image or the file could not be written.
  */
-std::vector<std::string> NFLSim::parseGameInfo(const std::string &teamName, const std::string &gameInfo, int week)
+bool NFLSim::compileLeague(const std::string &filename) const
 {
-    std::vector<std::string> parsedTokens;
-    std::stringstream gameInfoStream(gameInfo);
-    std::string token;
+    const int numTeams = static_cast<int>(teamsByIndex.size());
+    LeagueImageContents image;
+    image.numWeeks = static_cast<int>(NFLSchedule.empty() ? 0 : NFLSchedule[0].size());
+    for (const auto &teamSchedule : NFLSchedule)
+    {
+        if (static_cast<int>(NFLSchedule.size()) != numTeams || static_cast<int>(teamSchedule.size()) != image.numWeeks)
+        {
+            std::cerr << "Error: Every team needs a schedule row of the same length to compile the league" << std::endl;
+            return false;
+        }
+    }
 
-    // Add week number and team name to the parsed tokens
-    parsedTokens.push_back(std::to_string(week));
-    parsedTokens.push_back(teamName);
+    // Teams, with the conference and division they play in
+    image.teams.resize(numTeams);
+    for (const auto &conferencePair : leagueStructure)
+    {
+        for (const auto &divisionPair : conferencePair.second)
+        {
+            for (const auto &team : divisionPair.second)
+            {
+                LeagueImageTeam &record = image.teams[team->getScheduleIndex()];
+                if (!setImageString(record.name, team->getName()) || !setImageString(record.abbreviation, team->getAbbreviation()) ||
+                    !setImageString(record.color, team->getColor()) || !setImageString(record.city, team->getCity().name) ||
+                    !setImageString(record.conference, conferencePair.first) || !setImageString(record.division, divisionPair.first))
+                {
+                    std::cerr << "Error: A name of " << team->getAbbreviation() << " is too long for a league image" << std::endl;
+                    return false;
+                }
+                record.preseasonElo = preseasonElo[team->getScheduleIndex()];
+                record.elo = team->getEloRating();
+                record.latitude = team->getCity().latitude;
+                record.longitude = team->getCity().longitude;
+            }
+        }
+    }
 
-    // Split the game information string by '#' and add tokens to the parsed tokens
-    while (std::getline(gameInfoStream, token, '#'))
+    // Games and their results
+    for (const auto &game : seasonGames)
     {
-        parsedTokens.push_back(token);
+        LeagueImageGame record{};
+        record.eloRatingChange = game->getEloRatingChange();
+        record.homeScore = static_cast<int16_t>(game->getHomeTeamScore());
+        record.awayScore = static_cast<int16_t>(game->getAwayTeamScore());
+        record.home = static_cast<uint8_t>(game->getHomeTeam()->getScheduleIndex());
+        record.away = static_cast<uint8_t>(game->getAwayTeam()->getScheduleIndex());
+        record.week = static_cast<uint8_t>(game->getWeekNumber());
+        record.complete = game->isGameComplete() ? 1 : 0;
+        image.games.push_back(record);
+    }
+    for (const auto &weekGameIds : teamGameIds)
+    {
+        image.teamGameIds.insert(image.teamGameIds.end(), weekGameIds.begin(), weekGameIds.end());
     }
 
-    // Determine the home and away teams based on the '@' symbol
-    if (parsedTokens.size() > 2 && parsedTokens[2][0] == '@')
+    // Precomputed odds and score tables
+    image.restAdjustments = gameRestAdjustment;
+    for (int homeIndex = 0; homeIndex < numTeams; ++homeIndex)
     {
-        std::string homeTeam = parsedTokens[1];
-        parsedTokens[1] = parsedTokens[2].substr(1); // The team after '@' is the away team
-        parsedTokens[2] = homeTeam;                  // The current team is the home team
+        image.travelAdvantage.insert(image.travelAdvantage.end(), travelAdvantage[homeIndex].begin(), travelAdvantage[homeIndex].begin() + numTeams);
     }
+    image.scoreThresholds.assign(scoreThresholds.begin(), scoreThresholds.end());
+    image.scoreGuide.assign(scoreGuide.begin(), scoreGuide.end());
+    image.marginLogarithms.assign(marginLogarithms.begin(), marginLogarithms.end());
+    image.modelFingerprint = modelFingerprint;
 
-    return parsedTokens;
+    if (!LeagueImage::save(filename, image))
+    {
+        return false;
+    }
+    std::cout << "Compiled " << numTeams << " teams and " << seasonGames.size() << " games into " << filename << std::endl;
+    return true;
 }
 
 /**
  * @brief Reads team data from a CSV file and initializes the team maps and league structure.
  *
- * This function reads team data from the provided CSV file, processes each line to extract team information,
+ * This function maps the provided CSV file, parses each line to extract team information,
  * and creates Team objects for each team. It updates the team maps and league structure with the parsed team data.
  *
  * @param filename The name of the CSV file containing the team data.
+ * @return False if the file could not be read or is malformed; the error is printed with its line and column.
  */
-void NFLSim::readTeams(const std::string &filename)
+bool NFLSim::readTeams(const std::string &filename)
 {
-    std::ifstream file(filename);
-
-    if (!file.is_open())
+    CsvReader reader;
+    if (!reader.open(filename))
     {
-        std::cerr << "Error: Could not open file " << filename << "\n";
-        return;
+        return false;
     }
 
-    std::string line;
-    std::getline(file, line); // Skip header
+    reader.nextRow(); // Skip header
 
+    // Field order: name, abbreviation, color, Elo, city, latitude, longitude, conference, division
+    const int numFields = 9;
     int teamIndex = 0; // Initialize team index to track team position
-    while (std::getline(file, line))
-    {
-        std::stringstream ss(line);
-        std::string teamName, abbreviation, color, city, eloStr, latStr, lonStr, conference, division;
-
-        // Read each field from the CSV file
-        std::getline(ss, teamName, ',');
-        std::getline(ss, abbreviation, ',');
-        std::getline(ss, color, ',');
-        std::getline(ss, eloStr, ',');
-        std::getline(ss, city, ',');
-        std::getline(ss, latStr, ',');
-        std::getline(ss, lonStr, ',');
-        std::getline(ss, conference, ','); // Ensure these fields are present in the file
-        std::getline(ss, division, ',');   // Ensure these fields are present in the file
-
-        double elo = std::stod(eloStr);
-        double latitude = std::stod(latStr);
-        double longitude = std::stod(lonStr);
+    while (reader.nextRow())
+    {
+        if (teamIndex >= MAX_TEAMS)
+        {
+            std::cerr << "Error: More than " << MAX_TEAMS << " teams in " << filename << "\n";
+            return false;
+        }
+
+        std::string_view fields[numFields];
+        for (int i = 0; i < numFields; ++i)
+        {
+            if (!reader.nextField(fields[i]))
+            {
+                std::cerr << "Error: " << reader.location(fields[i > 0 ? i - 1 : 0]) << ": expected " << numFields << " fields" << std::endl;
+                return false;
+            }
+        }
+
+        double elo, latitude, longitude;
+        const int numberFields[] = {3, 5, 6};
+        double *numbers[] = {&elo, &latitude, &longitude};
+        for (int i = 0; i < 3; ++i)
+        {
+            std::string_view text = fields[numberFields[i]];
+            if (!parseField(text, *numbers[i]))
+            {
+                std::cerr << "Error: " << reader.location(text) << ": invalid number '" << text << "'" << std::endl;
+                return false;
+            }
+        }
 
         // Create a shared_ptr to a Team object
-        auto team = std::make_shared<Team>(teamName, abbreviation, color, elo, city, latitude, longitude, teamIndex);
+        std::string abbreviation(fields[1]);
+        auto team = std::make_shared<Team>(std::string(fields[0]), abbreviation, std::string(fields[2]), elo,
+                                           std::string(fields[4]), latitude, longitude, teamIndex);
 
         // Add the team to both maps
         teamMapByAbbreviation[abbreviation] = team;
 
         // Add the team to the league structure by conference and division
-        leagueStructure[conference][division].push_back(team);
+        leagueStructure[std::string(fields[7])][std::string(fields[8])].push_back(team);
 
         ++teamIndex;
     }
-
-    file.close();
+    return true;
 }
 
 /**
  * @brief Prints the schedule for all teams in the league.
  *
  * This function prints the schedule for each team in the league, including the team's name,
- * Elo rating, win count, and the details of each game in the schedule.
+ * Elo rating, win count, and the details of each game in the schedule. With the compact view,
+ * each team gets a single line instead. The schedule is rendered into the reusable report
+ * buffer and written to the terminal in one call.
  */
-void NFLSim::printSchedule() const
+void NFLSim::printSchedule()
 {
+    // Bring the odds of games whose teams' Elo ratings changed up to date
+    refreshOdds();
+
+    if (compactSchedule)
+    {
+        printCompactSchedule(scheduleReport);
+        scheduleReport.flush(std::cout);
+        return;
+    }
+
     // Define column widths for formatting
     const int teamColumnWidth = 20;
     const int weekColumnWidth = 7; // Width for "Week XX |"
     const int gameColumnWidth = 30;
 
     // Print header
-    std::cout << std::left << std::setw(teamColumnWidth) << "Team" << " | " << "Games" << std::endl;
-    std::cout << std::string(teamColumnWidth + weekColumnWidth + 3 + gameColumnWidth, '-') << std::endl;
+    size_t column = scheduleReport.mark();
+    scheduleReport.write("Team");
+    scheduleReport.padFrom(column, teamColumnWidth);
+    scheduleReport.write(" | Games");
+    scheduleReport.endLine();
+    scheduleReport.writeRepeated('-', teamColumnWidth + weekColumnWidth + 3 + gameColumnWidth);
+    scheduleReport.endLine();
 
     // Iterate over each conference and division in the league structure
     for (const auto &conferencePair : leagueStructure)
@@ -290,70 +846,142 @@ void NFLSim::printSchedule() const
         const auto &conference = conferencePair.first;
         const auto &divisions = conferencePair.second;
 
-        std::cout << "Conference: " << conference << std::endl;
+        scheduleReport.write("Conference: ");
+        scheduleReport.write(conference);
+        scheduleReport.endLine();
 
         for (const auto &divisionPair : divisions)
         {
             const auto &division = divisionPair.first;
             const auto &teams = divisionPair.second;
 
-            std::cout << conference << " " << division << std::endl;
+            scheduleReport.write(conference);
+            scheduleReport.write(" ");
+            scheduleReport.write(division);
+            scheduleReport.endLine();
 
             for (const auto &team : teams)
             {
                 // Print the team name, Elo rating, and win count
-                printTeamHeader(team, teamColumnWidth, weekColumnWidth, gameColumnWidth);
+                printTeamHeader(scheduleReport, *team, teamColumnWidth, weekColumnWidth, gameColumnWidth);
 
                 // Retrieve and print the games for the current team from the schedule
                 const auto &games = NFLSchedule.at(team->getScheduleIndex());
-                printTeamGames(team, games, teamColumnWidth, gameColumnWidth);
+                printTeamGames(scheduleReport, *team, games, teamColumnWidth, gameColumnWidth);
             }
         }
     }
+
+    scheduleReport.flush(std::cout);
 }
 
 /**
  * @brief Prints the header for a team, including the team's name, Elo rating, and win count.
  *
+ * @param report The report to write to.
  * @param team The team object.
  * @param teamColumnWidth The width of the team column.
  * @param weekColumnWidth The width of the week column.
  * @param gameColumnWidth The width of the game column.
  */
-void NFLSim::printTeamHeader(const std::shared_ptr<Team> &team, int teamColumnWidth, int weekColumnWidth, int gameColumnWidth) const
+void NFLSim::printTeamHeader(ReportWriter &report, const Team &team, int teamColumnWidth, int weekColumnWidth, int gameColumnWidth) const
 {
-    std::cout << std::left << std::setw(teamColumnWidth) << team->getName() << " | Elo: " << team->getEloRating() << " | Wins: " << team->getWinCount() << std::endl;
-    std::cout << std::string(teamColumnWidth + weekColumnWidth + 3 + gameColumnWidth, '-') << std::endl;
+    size_t column = report.mark();
+    report.write(team.getName());
+    report.padFrom(column, teamColumnWidth);
+    report.write(" | Elo: ");
+    report.writeGeneral(team.getEloRating());
+    report.write(" | Wins: ");
+    report.writeGeneral(team.getWinCount());
+    report.endLine();
+    report.writeRepeated('-', teamColumnWidth + weekColumnWidth + 3 + gameColumnWidth);
+    report.endLine();
 }
 
 /**
  * @brief Prints the games for a team.
  *
+ * @param report The report to write to.
  * @param team The team object.
  * @param games The vector of games for the team.
  * @param teamColumnWidth The width of the team column.
- * @param weekColumnWidth The width of the week column.
  * @param gameColumnWidth The width of the game column.
  */
-void NFLSim::printTeamGames(const std::shared_ptr<Team> &team, const std::vector<std::shared_ptr<Game>> &games, int teamColumnWidth, int gameColumnWidth) const
+void NFLSim::printTeamGames(ReportWriter &report, const Team &team, const std::vector<std::shared_ptr<Game>> &games, int teamColumnWidth, int gameColumnWidth) const
 {
     int weekIndex = 0;
 
     // Iterate over each game in the team's schedule
     for (const auto &game : games)
     {
-        std::cout << std::left << std::setw(teamColumnWidth) << ("Week " + std::to_string(weekIndex))
-                  << " | " << std::setw(gameColumnWidth) << game->getGameDetails(team) << std::endl;
+        size_t column = report.mark();
+        report.write("Week ");
+        report.writeInt(weekIndex);
+        report.padFrom(column, teamColumnWidth);
+        report.write(" | ");
+
+        column = report.mark();
+        game->writeGameDetails(report, team);
+        report.padFrom(column, gameColumnWidth);
+        report.endLine();
         ++weekIndex;
     }
 
-    std::cout << std::endl;
+    report.endLine();
 }
 
 /**
- * @brief Calculates the field advantage based on the distance between two cities.
+ * @brief Prints one line per team with its Elo rating, wins and a letter per week.
  *
- * This function calculates the field advantage for the home team based on the distance
+ * The letters are W, L and T for played games, - for games still to play and . for byes.
+ *
+ * @param report The report to write to.
+ */
+void NFLSim::printCompactSchedule(ReportWriter &report) const
+{
+    report.write("Team | Elo     | Wins | Weeks (W/L/T played, - to play, . bye)");
+    report.endLine();
+    report.writeRepeated('-', 64);
+    report.endLine();
+
+    for (const auto &team : teamsByIndex)
+    {
+        size_t column = report.mark();
+        report.write(team->getAbbreviation());
+        report.padFrom(column, 4);
+        report.write(" | ");
+        column = report.mark();
+        report.writeFixed(team->getEloRating(), 2);
+        report.padFrom(column, 7);
+        report.write(" | ");
+        column = report.mark();
+        report.writeGeneral(team->getWinCount());
+        report.padFrom(column, 4);
+        report.write(" | ");
+
+        for (const auto &game : NFLSchedule[team->getScheduleIndex()])
+        {
+            char result = '.';
+            if (!game->isByeWeek())
+            {
+                int pointDifference = game->getHomeTeamScore() - game->getAwayTeamScore();
+                if (game->getAwayTeam() == team)
+                {
+                    pointDifference = -pointDifference;
+                }
+                result = !game->isGameComplete() ? '-' : pointDifference > 0 ? 'W' : pointDifference < 0 ? 'L' : 'T';
+            }
+            report.write(std::string_view(&result, 1));
+        }
+        report.endLine();
+    }
+    report.endLine();
+}
+
+/**
+ * @brief Calculates the field advantage based on the distance between two cities.
+ *
+ * This function calculates the field advantage for the home team based on the distance
  * between the home and away cities. The advantage is calculated using the Haversine formula
  * to determine the distance in miles, and then applying a point advantage based on the distance.
  *
@@ -361,7 +989,7 @@ void NFLSim::printTeamGames(const std::shared_ptr<Team> &team, const std::vector
  * @param awayCity The city of the away team.
  * @return The calculated field advantage in points.
  */
-double NFLSim::calculateFieldAdvantage(const City &homeCity, const City &awayCity)
+double NFLSim::calculateFieldAdvantage(const City &homeCity, const City &awayCity) const
 {
     constexpr double EARTH_RADIUS_METERS = 6378137.0; // Radius of the Earth in meters
 
@@ -391,34 +1019,45 @@ double NFLSim::calculateFieldAdvantage(const City &homeCity, const City &awayCit
 }
 
 /**
- * @brief Adjusts the Elo rating difference for bye weeks.
+ * @brief Precomputes the static parts of the Elo difference of every game.
  *
- * This function adjusts the Elo rating difference between the home and away teams
- * based on whether either team has a bye week.
- *
- * @param game The game object.
- * @param homeTeam The home team.
- * @param awayTeam The away team.
- * @return The adjusted Elo rating difference.
+ * The travel advantage only depends on the two teams' cities and is stored for every
+ * pair of teams, so playoff games can use it as well. The rest adjustment gives a team
+ * coming off a bye week 25 Elo points and is stored for every game of the schedule.
+ * Odds calculation is then a table lookup plus one logistic.
  */
-double NFLSim::adjustEloForByes(const Game &game, const Team &homeTeam, const Team &awayTeam)
+void NFLSim::buildAdjustmentTables()
 {
-    double eloDifference = homeTeam.getEloRating() - awayTeam.getEloRating();
-
-    int homeTeamIndex = homeTeam.getScheduleIndex();
-    int awayTeamIndex = awayTeam.getScheduleIndex();
-    int week = game.getWeekNumber();
-
-    if (NFLSchedule[homeTeamIndex][week]->getAwayTeam()->getName() == homeTeam.getName())
+    for (const auto &homePair : teamMapByAbbreviation)
     {
-        eloDifference += 25;
+        for (const auto &awayPair : teamMapByAbbreviation)
+        {
+            const auto &homeTeam = homePair.second;
+            const auto &awayTeam = awayPair.second;
+            travelAdvantage[homeTeam->getScheduleIndex()][awayTeam->getScheduleIndex()] =
+                calculateFieldAdvantage(homeTeam->getCity(), awayTeam->getCity());
+        }
     }
-    if (NFLSchedule[awayTeamIndex][week]->getAwayTeam()->getName() == awayTeam.getName())
+
+    gameRestAdjustment.assign(seasonGames.size(), 0.0);
+    for (size_t gameId = 0; gameId < seasonGames.size(); ++gameId)
     {
-        eloDifference -= 25;
-    }
+        Game &game = *seasonGames[gameId];
+        int homeIndex = game.getHomeTeam()->getScheduleIndex();
+        int awayIndex = game.getAwayTeam()->getScheduleIndex();
+        int week = game.getWeekNumber();
+
+        if (week > 0 && teamGameIds[homeIndex][week - 1] < 0)
+        {
+            gameRestAdjustment[gameId] += 25;
+        }
+        if (week > 0 && teamGameIds[awayIndex][week - 1] < 0)
+        {
+            gameRestAdjustment[gameId] -= 25;
+        }
 
-    return eloDifference;
+        game.setFieldAdvantage(travelAdvantage[homeIndex][awayIndex]);
+    }
 }
 
 /**
@@ -428,49 +1067,64 @@ double NFLSim::adjustEloForByes(const Game &game, const Team &homeTeam, const Te
  * the difference in Elo ratings between the home and away teams.
  *
  * @param eloDifference The difference in Elo ratings between the home and away teams.
+ * @param mode The Elo math to use.
  * @return The probability of the home team winning.
  */
-double NFLSim::calculateHomeOddsFromEloDiff(double eloDifference)
+double NFLSim::calculateHomeOddsFromEloDiff(double eloDifference, MathMode mode) const
+{
+    return EloMath::logistic(eloDifference, mode);
+}
+
+/**
+ * @brief Tilts the home odds of a game toward the importance sampling target.
+ *
+ * The target team gets run.importanceTilt extra Elo points, which multiplies its odds
+ * ratio by e^(importanceTilt / 400). Games without the target keep their odds.
+ *
+ * @param run The settings of the run, with the target and its tilt.
+ * @param homeOdds The probability of the home team winning.
+ * @param homeIndex The schedule index of the home team.
+ * @param awayIndex The schedule index of the away team.
+ * @return The probability to draw the home team's win with.
+ */
+double NFLSim::tiltHomeOdds(const RunConfig &run, double homeOdds, int homeIndex, int awayIndex) const
 {
-    return 1.0 / (1.0 + std::exp(-eloDifference / 400.0));
+    if (homeIndex == run.importanceTeam)
+    {
+        return 1.0 / (1.0 + (1.0 / homeOdds - 1.0) * run.importanceFactor);
+    }
+    if (awayIndex == run.importanceTeam)
+    {
+        return 1.0 / (1.0 + (1.0 / homeOdds - 1.0) / run.importanceFactor);
+    }
+    return homeOdds;
 }
 
 /**
  * @brief Calculates the home team odds for a game.
  *
  * This function calculates the odds of the home team winning a game by adjusting the
- * Elo rating difference for bye weeks and field advantage, and then calculating the
- * probability based on the adjusted Elo difference.
+ * Elo rating difference with the precomputed travel and rest adjustments, and then
+ * calculating the probability based on the adjusted Elo difference.
  *
  * @param game A shared pointer to the game object.
  */
 void NFLSim::calculateHomeOdds(std::shared_ptr<Game> &game)
 {
-    // Access the home and away teams via shared pointers
-    auto homeTeam = game->getHomeTeam();
-    auto awayTeam = game->getAwayTeam();
-
     // If bye week, skip odds calculation
-    if (homeTeam->getName() == awayTeam->getName())
+    if (game->isByeWeek())
     {
         return;
     }
 
-    double eloDifference = adjustEloForByes(*game, *homeTeam, *awayTeam);
+    int homeIndex = game->getHomeTeam()->getScheduleIndex();
+    int awayIndex = game->getAwayTeam()->getScheduleIndex();
+    int gameId = teamGameIds[homeIndex][game->getWeekNumber()];
 
-    // If distance hasn't been calculated before, do it; else grab the value
-    if (game->getFieldAdvantage() == -1)
-    {
-        double fieldAdvantage = calculateFieldAdvantage(homeTeam->getCity(), awayTeam->getCity());
-        game->setFieldAdvantage(fieldAdvantage);
-        eloDifference += fieldAdvantage;
-    }
-    else
-    {
-        eloDifference += game->getFieldAdvantage();
-    }
+    double eloDifference = game->getHomeTeam()->getEloRating() - game->getAwayTeam()->getEloRating();
+    eloDifference += travelAdvantage[homeIndex][awayIndex] + gameRestAdjustment[gameId];
 
-    double homeOdds = calculateHomeOddsFromEloDiff(eloDifference);
+    double homeOdds = calculateHomeOddsFromEloDiff(eloDifference, config.mathMode);
     game->setHomeTeamOdds(homeOdds);
 }
 
@@ -495,22 +1149,38 @@ void NFLSim::processAllGames()
 }
 
 /**
- * @brief Processes games for a specific team to calculate initial odds.
+ * @brief Marks the odds of a team's remaining games as stale.
  *
- * This function retrieves the weekly schedule for the specified team and iterates over each game.
- * For each game that is not complete, it calculates the home team odds.
+ * The odds of a game only depend on the Elo ratings of its two teams, so after a
+ * team's Elo rating changes only that team's games need new odds. They are
+ * recalculated by refreshOdds the next time they are displayed.
  *
  * @param teamIndex The index of the team in the schedule.
  */
-void NFLSim::processTeamGames(int teamIndex)
+void NFLSim::markTeamOddsDirty(int teamIndex)
 {
-    auto &weeklySchedule = NFLSchedule[teamIndex];
+    for (auto &gamePtr : NFLSchedule[teamIndex])
+    {
+        if (!gamePtr->isGameComplete() && !gamePtr->isByeWeek())
+        {
+            gamePtr->markOddsDirty();
+        }
+    }
+}
 
-    for (auto &gamePtr : weeklySchedule)
+/**
+ * @brief Recalculates the odds of every game that has been marked as stale.
+ */
+void NFLSim::refreshOdds()
+{
+    for (auto &weeklySchedule : NFLSchedule)
     {
-        if (!gamePtr->isGameComplete())
+        for (auto &gamePtr : weeklySchedule)
         {
-            calculateHomeOdds(gamePtr);
+            if (gamePtr->isOddsDirty())
+            {
+                calculateHomeOdds(gamePtr);
+            }
         }
     }
 }
@@ -564,7 +1234,8 @@ void NFLSim::saveScheduelAsCSV(const std::string &filename) const
  * @brief Allows manual entry of game results and updates the simulation accordingly.
  *
  * This function prompts the user to enter a team abbreviation, game week, and score.
- * It then updates the game result, recalculates Elo ratings, and processes the games for both teams.
+ * It then updates the game result, recalculates Elo ratings, and marks the odds of both
+ * teams' games as stale.
  */
 void NFLSim::manualGameResults()
 {
@@ -626,6 +1297,20 @@ void NFLSim::manualGameResults()
 
     auto &gamePtr = NFLSchedule[scheduleIndex][week];
     auto &game = *gamePtr;
+    if (game.isByeWeek())
+    {
+        std::cerr << "Error: " << teamAbbreviation << " has a bye in week " << week << std::endl;
+        return;
+    }
+
+    int homeIndex = game.getHomeTeam()->getScheduleIndex();
+    int awayIndex = game.getAwayTeam()->getScheduleIndex();
+
+    // Take back the head-to-head result of a game entered before
+    if (game.isGameComplete())
+    {
+        seasonResults.remove(homeIndex, awayIndex, game.getHomeTeamScore(), game.getAwayTeamScore());
+    }
 
     // If game has previously been completed, reset the elo rating effects from
     // the previous update
@@ -643,8 +1328,8 @@ void NFLSim::manualGameResults()
         game.setAwayTeamScore(0);
         game.setGameComplete(false);
         game.setEloRatingChange(0);
-        processTeamGames(game.getHomeTeam()->getScheduleIndex());
-        processTeamGames(game.getAwayTeam()->getScheduleIndex());
+        markTeamOddsDirty(game.getHomeTeam()->getScheduleIndex());
+        markTeamOddsDirty(game.getAwayTeam()->getScheduleIndex());
         game.setUserSet(false);
         std::cout << "Game reset." << std::endl;
         return;
@@ -653,6 +1338,7 @@ void NFLSim::manualGameResults()
     game.setHomeTeamScore(homeScore);
     game.setAwayTeamScore(awayScore);
     game.setGameComplete(true);
+    seasonResults.record(homeIndex, awayIndex, homeScore, awayScore);
 
     if (homeScore == awayScore)
     {
@@ -666,22 +1352,55 @@ void NFLSim::manualGameResults()
         if (homeScore > awayScore)
         {
             game.getHomeTeam()->updateWinCount(1);
-            game.getAwayTeam()->addLoss(game.getHomeTeam(), homeScore - awayScore);
         }
         else
         {
             game.getAwayTeam()->updateWinCount(1);
-            game.getHomeTeam()->addLoss(game.getAwayTeam(), awayScore - homeScore);
         }
     }
 
     game.setUserSet(true);
-    processTeamGames(game.getHomeTeam()->getScheduleIndex());
-    processTeamGames(game.getAwayTeam()->getScheduleIndex());
+    markTeamOddsDirty(game.getHomeTeam()->getScheduleIndex());
+    markTeamOddsDirty(game.getAwayTeam()->getScheduleIndex());
 
     std::cout << "Game and Elo updated." << std::endl;
 }
 
+/**
+ * @brief Calculates the Elo rating change of the home team for a game result.
+ *
+ * The change is based on the game result, the margin of victory and the Elo
+ * difference between the teams. The away team changes by the negated amount.
+ *
+ * @param homeElo The Elo rating of the home team before the game.
+ * @param awayElo The Elo rating of the away team before the game.
+ * @param homeScore The score of the home team.
+ * @param awayScore The score of the away team.
+ * @param mode The Elo math to use.
+ * @return The Elo rating change of the home team.
+ */
+double NFLSim::calculateEloChange(double homeElo, double awayElo, int homeScore, int awayScore, MathMode mode) const
+{
+    double actualResult = (homeScore > awayScore) ? 1.0 : (homeScore < awayScore) ? 0.0
+                                                                                  : 0.5;
+
+    return EloMath::eloChange(homeElo - awayElo, actualResult, marginLogarithm(std::abs(homeScore - awayScore)), mode);
+}
+
+/**
+ * @brief Gets the natural logarithm of a point difference plus one.
+ * @param pointDifference The absolute point difference of a game.
+ * @return ln(pointDifference + 1), from the precomputed table when possible.
+ */
+double NFLSim::marginLogarithm(int pointDifference) const
+{
+    if (pointDifference < static_cast<int>(marginLogarithms.size()))
+    {
+        return marginLogarithms[pointDifference];
+    }
+    return std::log(static_cast<double>(pointDifference) + 1.0);
+}
+
 /**
  * @brief Updates the Elo ratings for a game based on the result.
  *
@@ -692,10 +1411,6 @@ void NFLSim::manualGameResults()
  */
 void NFLSim::updateEloRatings(std::shared_ptr<Game> gamePtr)
 {
-    const double K = 4.0;                   // K-factor
-    const double MOV_MULTIPLIER_BASE = 2.2; // Base for margin-of-victory multiplier
-    const double MOV_SCALE = 0.001;         // Scaling factor for Elo difference
-
     auto &game = *gamePtr;
 
     auto homeTeamPtr = game.getHomeTeam();
@@ -710,618 +1425,1928 @@ void NFLSim::updateEloRatings(std::shared_ptr<Game> gamePtr)
     auto &homeTeam = *homeTeamPtr;
     auto &awayTeam = *awayTeamPtr;
 
-    double homeElo = homeTeam.getEloRating();
-    double awayElo = awayTeam.getEloRating();
-
-    int homeScore = game.getHomeTeamScore();
-    int awayScore = game.getAwayTeamScore();
-
-    double eloDifference = homeElo - awayElo;
-    double homeWinProbability = 1.0 / (1.0 + std::exp(-eloDifference / 400.0));
-
-    double actualResult = (homeScore > awayScore) ? 1.0 : (homeScore < awayScore) ? 0.0
-                                                                                  : 0.5;
-
-    double forecastDelta = actualResult - homeWinProbability;
-
-    double pointDifference = std::abs(homeScore - awayScore);
-    double movMultiplier = std::log(pointDifference + 1) * MOV_MULTIPLIER_BASE;
-
-    double eloAdjustment = movMultiplier * (eloDifference * MOV_SCALE + MOV_MULTIPLIER_BASE);
-
-    double homeEloAdjustment = K * forecastDelta * eloAdjustment;
-    double awayEloAdjustment = -homeEloAdjustment;
-
-    homeElo += homeEloAdjustment;
-    awayElo += awayEloAdjustment;
+    double homeEloAdjustment = calculateEloChange(homeTeam.getEloRating(), awayTeam.getEloRating(),
+                                                  game.getHomeTeamScore(), game.getAwayTeamScore(), config.mathMode);
 
     homeTeam.updateEloRating(homeEloAdjustment);
-    awayTeam.updateEloRating(awayEloAdjustment);
+    awayTeam.updateEloRating(-homeEloAdjustment);
 
     game.setEloRatingChange(homeEloAdjustment);
 }
 
 /**
- * @brief Simulates the regular season games.
+ * @brief Updates the Elo ratings in a season state for a game based on the result.
+ * @param state The season state.
+ * @param homeIndex The schedule index of the home team.
+ * @param awayIndex The schedule index of the away team.
+ * @param homeScore The score of the home team.
+ * @param awayScore The score of the away team.
+ * @param mode The Elo math to use.
+ */
+void NFLSim::updateEloRatings(SeasonState &state, int homeIndex, int awayIndex, int homeScore, int awayScore, MathMode mode) const
+{
+    double homeEloAdjustment = calculateEloChange(state.teamElo[homeIndex], state.teamElo[awayIndex], homeScore, awayScore, mode);
+
+    state.teamElo[homeIndex] += homeEloAdjustment;
+    state.teamElo[awayIndex] -= homeEloAdjustment;
+}
+
+/**
+ * @brief Builds the chronological game index from the games read from the schedule.
  *
- * This function iterates through each week and each game in the schedule,
- * generating random scores and determining the outcome of each game.
- * It updates the game results, Elo ratings, and processes the games for each team.
- * Finally, it determines the playoff teams and simulates the playoffs.
+ * Every game appears twice in NFLSchedule, once in each team's row, but only once in
+ * seasonGames. The games are ordered by week and weekGameOffsets stores where each
+ * week starts, so the games of week w have the ids [weekGameOffsets[w], weekGameOffsets[w + 1]).
+ * Each team's weekly schedule is also translated into game ids (-1 for bye weeks).
  */
-void NFLSim::simulateRegularSeason()
+void NFLSim::buildGameIndex()
 {
-    // Initialize the random number generator with a random seed
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-    std::lognormal_distribution<> scoreDis(1.0, 0.5);
+    std::stable_sort(seasonGames.begin(), seasonGames.end(),
+                     [](const std::shared_ptr<Game> &a, const std::shared_ptr<Game> &b)
+                     {
+                         return a->getWeekNumber() < b->getWeekNumber();
+                     });
+
+    // Offsets of the first game of every week
+    int numWeeks = seasonGames.empty() ? 0 : seasonGames.back()->getWeekNumber() + 1;
+    weekGameOffsets.assign(numWeeks + 1, 0);
+    for (const auto &game : seasonGames)
+    {
+        ++weekGameOffsets[game->getWeekNumber() + 1];
+    }
+    std::partial_sum(weekGameOffsets.begin(), weekGameOffsets.end(), weekGameOffsets.begin());
 
-    // Iterate through each week
-    for (const auto &weeklyGames : NFLSchedule)
+    // Game id of every team's game in every week
+    std::unordered_map<const Game *, int> gameIds;
+    for (size_t gameId = 0; gameId < seasonGames.size(); ++gameId)
     {
-        // Iterate through each game in the week
-        for (const auto &game : weeklyGames)
-        {
-            // Skip if the game is already complete
-            if (game->isGameComplete())
-                continue;
+        gameIds[seasonGames[gameId].get()] = static_cast<int>(gameId);
+    }
 
-            // Generate a random float between 0 and 1
-            float randomValue = dis(gen);
+    teamGameIds.assign(NFLSchedule.size(), {});
+    for (size_t teamIndex = 0; teamIndex < NFLSchedule.size(); ++teamIndex)
+    {
+        for (const auto &game : NFLSchedule[teamIndex])
+        {
+            teamGameIds[teamIndex].push_back(game->isByeWeek() ? -1 : gameIds.at(game.get()));
+        }
+    }
+}
 
-            // Generate scores using a log-normal distribution
-            int homeScore = static_cast<int>(scoreDis(gen));
-            int awayScore = static_cast<int>(scoreDis(gen));
+/**
+ * @brief Builds the league layout used by season states.
+ *
+ * Teams are indexed by schedule index, and conferences and divisions are stored as
+ * lists of team indices, with the division and the division and conference rivals of
+ * every team.
+ */
+void NFLSim::buildSeasonLayout()
+{
+    teamsByIndex.assign(teamMapByAbbreviation.size(), nullptr);
+    conferenceDivisions.clear();
 
-            int winningScore, losingScore;
-            std::shared_ptr<Team> winningTeam, losingTeam;
+    for (const auto &teamPair : teamMapByAbbreviation)
+    {
+        teamsByIndex[teamPair.second->getScheduleIndex()] = teamPair.second;
+    }
 
-            // Determine if the game ends in a tie
-            if (randomValue < 0.01f)
+    int divisionNumber = 0;
+    for (const auto &conferencePair : leagueStructure)
+    {
+        std::vector<std::vector<int>> divisions;
+        uint32_t conferenceTeams = 0;
+        for (const auto &divisionPair : conferencePair.second)
+        {
+            std::vector<int> division;
+            uint32_t divisionTeams = 0;
+            for (const auto &team : divisionPair.second)
             {
-                game->setHomeTeamScore(homeScore);
-                game->setAwayTeamScore(homeScore); // Both teams get the same score
-                game->getHomeTeam()->updateWinCount(0.5);
-                game->getAwayTeam()->updateWinCount(0.5);
+                division.push_back(team->getScheduleIndex());
+                teamDivision[team->getScheduleIndex()] = divisionNumber;
+                divisionTeams |= 1u << team->getScheduleIndex();
             }
-            else
+            for (int team : division)
             {
-                // Ensure that one score is higher than the other
-                winningScore = std::max(homeScore, awayScore);
-                losingScore = std::min(homeScore, awayScore);
-                if (winningScore == losingScore)
-                    winningScore++; // Avoid ties unless specified
-
-                // Determine the winning and losing team
-                if (randomValue > game->getHomeTeamOdds())
-                {
-                    game->setAwayTeamScore(winningScore);
-                    game->setHomeTeamScore(losingScore);
-                    winningTeam = game->getAwayTeam();
-                    losingTeam = game->getHomeTeam();
-                    winningTeam->updateWinCount(1);
-                }
-                else
-                {
-                    game->setHomeTeamScore(winningScore);
-                    game->setAwayTeamScore(losingScore);
-                    winningTeam = game->getHomeTeam();
-                    losingTeam = game->getAwayTeam();
-                    winningTeam->updateWinCount(1);
-                }
+                divisionRivals[team] = divisionTeams & ~(1u << team);
             }
-
-            // Mark the game as complete and update Elo ratings
-            game->setGameComplete(true);
-            updateEloRatings(game);
-
-            // Process games for each team
-            processTeamGames(game->getHomeTeam()->getScheduleIndex());
-            processTeamGames(game->getAwayTeam()->getScheduleIndex());
-
-            // Record the loss for the losing team
-            if (winningTeam && losingTeam)
+            conferenceTeams |= divisionTeams;
+            divisions.push_back(division);
+            ++divisionNumber;
+        }
+        for (const auto &division : divisions)
+        {
+            for (int team : division)
             {
-                int pointDifferential = winningScore - losingScore;
-                losingTeam->addLoss(winningTeam, pointDifferential);
+                conferenceRivals[team] = conferenceTeams & ~(1u << team);
             }
         }
+        conferenceDivisions.push_back(divisions);
     }
+}
 
-    // Determine division winners and print league structure
-    determinePlayoffTeams();
-    simulatePlayoffs();
+/**
+ * @brief Records the results of the completed games in the head-to-head matrix.
+ */
+void NFLSim::buildSeasonResults()
+{
+    seasonResults.clear();
+    for (const auto &game : seasonGames)
+    {
+        if (game->isGameComplete())
+        {
+            seasonResults.record(game->getHomeTeam()->getScheduleIndex(), game->getAwayTeam()->getScheduleIndex(),
+                                 game->getHomeTeamScore(), game->getAwayTeamScore());
+        }
+    }
 }
 
 /**
- * @brief Determines the playoff teams.
- *
- * This function determines the division winners and wildcard teams,
- * and sets the playoff status for each team.
+ * @brief Sizes the game arrays of a season state and fills in who plays when.
+ * @param state The season state, with no games completed afterwards.
  */
-void NFLSim::determinePlayoffTeams()
+void NFLSim::fillGameLayout(SeasonState &state) const
 {
-    playoffSeeding.clear();
-    determineDivisionWinners();
-    determineWildCardTeams();
-    for (auto &team : teamMapByAbbreviation)
+    state.numTeams = static_cast<int>(teamsByIndex.size());
+    state.resizeGames(static_cast<int>(seasonGames.size()));
+    for (int gameId = 0; gameId < state.numGames; ++gameId)
     {
-        team.second->setPlayoffStatus(true);
+        const Game &game = *seasonGames[gameId];
+        state.gameHome[gameId] = static_cast<uint8_t>(game.getHomeTeam()->getScheduleIndex());
+        state.gameAway[gameId] = static_cast<uint8_t>(game.getAwayTeam()->getScheduleIndex());
+        state.gameWeek[gameId] = static_cast<uint8_t>(game.getWeekNumber());
     }
 }
 
 /**
- * @brief Determines the division winners for each conference.
+ * @brief Builds the season state every simulated season starts from.
+ *
+ * Teams start from their current Elo ratings and the wins of all completed games.
+ * The odds of the remaining games are calculated when they are simulated.
  *
- * This function iterates through each conference and division,
- * sorts the teams by win count, and resolves any ties to determine
- * the top teams in each division. The division winners are added
- * to the playoff seeding.
+ * @return The initial season state.
  */
-void NFLSim::determineDivisionWinners()
+SeasonState NFLSim::buildSeasonState() const
 {
-    // Data structure to store the top teams from each division for each conference
-    std::map<std::string, std::vector<std::shared_ptr<Team>>> conferenceTeams;
-
-    // Iterate through each conference
-    for (const auto &conferencePair : leagueStructure)
+    SeasonState state;
+    fillGameLayout(state);
+    for (int team = 0; team < state.numTeams; ++team)
     {
-        const std::string &conference = conferencePair.first;
+        state.teamElo[team] = teamsByIndex[team]->getEloRating();
+    }
 
-        // Vector to store top teams of this conference
-        std::vector<std::shared_ptr<Team>> topTeams;
+    for (int gameId = 0; gameId < state.numGames; ++gameId)
+    {
+        const Game &game = *seasonGames[gameId];
+        int homeIndex = state.gameHome[gameId];
+        int awayIndex = state.gameAway[gameId];
 
-        // Iterate through each division in the conference
-        for (const auto &divisionPair : conferencePair.second)
+        if (game.isGameComplete())
         {
-            const std::vector<std::shared_ptr<Team>> &teams = divisionPair.second;
-
-            // Create a copy of the teams vector and sort it by win count
-            std::vector<std::shared_ptr<Team>> sortedTeams = teams;
-            std::sort(sortedTeams.begin(), sortedTeams.end(),
-                      [](const std::shared_ptr<Team> &a, const std::shared_ptr<Team> &b)
-                      {
-                          return a->getWinCount() > b->getWinCount();
-                      });
+            int homeScore = game.getHomeTeamScore();
+            int awayScore = game.getAwayTeamScore();
+            state.gameComplete[gameId] = 1;
+            state.gameHomeScore[gameId] = static_cast<int16_t>(homeScore);
+            state.gameAwayScore[gameId] = static_cast<int16_t>(awayScore);
 
-            // Handle ties within the division
-            if (sortedTeams.size() > 1)
+            if (homeScore == awayScore)
             {
-                std::vector<std::shared_ptr<Team>> topTeamsInDivision;
-
-                // Compare top teams to resolve any ties
-                for (size_t i = 0; i < sortedTeams.size(); ++i)
-                {
-                    for (size_t j = i + 1; j < sortedTeams.size(); ++j)
-                    {
-                        if (sortedTeams[i]->getWinCount() == sortedTeams[j]->getWinCount())
-                        {
-                            // Resolve tiebreaker between these two teams
-                            auto winner = resolveTiebreaker(sortedTeams[i], sortedTeams[j]);
-                            if (winner == sortedTeams[i])
-                            {
-                                topTeamsInDivision.push_back(sortedTeams[i]);
-                            }
-                            else
-                            {
-                                topTeamsInDivision.push_back(sortedTeams[j]);
-                            }
-                        }
-                        else
-                        {
-                            topTeamsInDivision.push_back(sortedTeams[i]);
-                            break; // Break once a non-tied team is added
-                        }
-                    }
-                }
-
-                // Ensure the top team of this division is unique
-                if (!topTeamsInDivision.empty())
-                {
-                    topTeams.push_back(topTeamsInDivision.front());
-                }
+                state.teamWins[homeIndex] += 0.5f;
+                state.teamWins[awayIndex] += 0.5f;
             }
-            else if (!sortedTeams.empty())
+            else
             {
-                // If no ties, just add the top team directly
-                topTeams.push_back(sortedTeams.front());
+                state.teamWins[homeScore > awayScore ? homeIndex : awayIndex] += 1;
             }
         }
+    }
 
-        // Sort the top teams by win count
-        std::sort(topTeams.begin(), topTeams.end(),
-                  [](const std::shared_ptr<Team> &a, const std::shared_ptr<Team> &b)
-                  {
-                      return a->getWinCount() > b->getWinCount();
-                  });
-
-        // Store the sorted top teams for this conference
-        conferenceTeams[conference] = topTeams;
+    state.headToHead = seasonResults;
 
-        // Add division winners to playoff seeding
-        if (conferenceTeams[conference].size() > 0)
-        {
-            playoffSeeding[conference] = conferenceTeams[conference]; // Add to playoff seeding
-        }
+    // Completed games are certain, so they count fully towards the expected wins
+    for (int team = 0; team < state.numTeams; ++team)
+    {
+        state.teamExpectedWins[team] = state.teamWins[team];
     }
+
+    return state;
 }
 
 /**
- * @brief Determines the wildcard teams for each conference.
+ * @brief Builds the season state every simulated season of a what-if snapshot starts from.
+ *
+ * Teams start from the Elo ratings and wins after all results known in the snapshot.
  *
- * This function iterates through each conference, identifies the non-division winners,
- * sorts them by win count, and selects the top teams for the wildcard spots.
- * The wildcard teams are then added to the playoff seeding.
+ * @param snapshot The snapshot to start from.
+ * @return The initial season state.
  */
-void NFLSim::determineWildCardTeams()
+SeasonState NFLSim::buildSeasonState(const SeasonSnapshot &snapshot) const
 {
-    // Data structure to store wildcard teams for each conference
-    std::map<std::string, std::vector<std::shared_ptr<Team>>> wildcardTeams;
-
-    // Clear the existing playoff seeding to prepare for wildcards
-    for (auto &conferencePair : playoffSeeding)
+    SeasonState state;
+    fillGameLayout(state);
+    state.teamElo = snapshot.currentElo();
+    if (!snapshot.weeks.empty())
     {
-        const std::string &conference = conferencePair.first;
-        auto &divisionWinners = conferencePair.second;
+        state.teamWins = snapshot.weeks.back()->winsAfter;
+    }
 
-        // Get all teams excluding division winners
-        std::vector<std::shared_ptr<Team>> nonPlayoffTeams;
-        for (const auto &divisionPair : leagueStructure[conference])
+    for (const auto &week : snapshot.weeks)
+    {
+        for (size_t game = 0; game < week->complete.size(); ++game)
         {
-            for (const auto &team : divisionPair.second)
+            int gameId = week->firstGame + static_cast<int>(game);
+            state.gameComplete[gameId] = week->complete[game];
+            state.gameHomeScore[gameId] = week->homeScore[game];
+            state.gameAwayScore[gameId] = week->awayScore[game];
+            state.gameOdds[gameId] = week->odds[game];
+            if (state.gameComplete[gameId])
             {
-                if (std::find(divisionWinners.begin(), divisionWinners.end(), team) == divisionWinners.end())
-                {
-                    nonPlayoffTeams.push_back(team);
-                }
+                state.recordResult(gameId);
             }
         }
+    }
 
-        // Sort non-playoff teams by win count
-        std::sort(nonPlayoffTeams.begin(), nonPlayoffTeams.end(),
-                  [](const std::shared_ptr<Team> &a, const std::shared_ptr<Team> &b)
-                  {
-                      return a->getWinCount() > b->getWinCount();
-                  });
-
-        // Select top 3 teams for wildcard spots
-        std::vector<std::shared_ptr<Team>> topWildCardTeams;
-        for (size_t i = 0; i < 3 && i < nonPlayoffTeams.size(); ++i)
-        {
-            topWildCardTeams.push_back(nonPlayoffTeams[i]);
-        }
-
-        // Store wildcard teams for this conference
-        wildcardTeams[conference] = topWildCardTeams;
-
-        // Add wildcard teams to playoff seeding
-        playoffSeeding[conference].insert(playoffSeeding[conference].end(),
-                                          topWildCardTeams.begin(), topWildCardTeams.end());
+    // Completed games are certain, so they count fully towards the expected wins
+    for (int team = 0; team < state.numTeams; ++team)
+    {
+        state.teamExpectedWins[team] = state.teamWins[team];
     }
+
+    return state;
 }
 
 /**
- * @brief Resolves a tiebreaker between two teams.
+ * @brief Takes a snapshot of the results currently in the schedule.
  *
- * This function determines the winner between two teams based on their losses and point differentials.
- * If the teams have not played each other or the point differentials are the same, a random choice is made.
+ * The results are replayed from the preseason Elo ratings in the order they were played.
  *
- * @param team1 The first team.
- * @param team2 The second team.
- * @return The team that wins the tiebreaker.
+ * @return The snapshot, sharing nothing with earlier snapshots.
  */
-std::shared_ptr<Team> NFLSim::resolveTiebreaker(const std::shared_ptr<Team> &team1,
-                                                const std::shared_ptr<Team> &team2)
+SeasonSnapshot NFLSim::takeSnapshot() const
 {
-    auto team1Losses = team1->getLosses();
-    auto team2Losses = team2->getLosses();
-
-    // Seed the random number generator if not already seeded
-    static bool seeded = false;
-    if (!seeded)
-    {
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-        seeded = true;
-    }
-
-    // Check if both teams have played each other
-    auto team1LostToTeam2 = team1Losses.find(team2);
-    auto team2LostToTeam1 = team2Losses.find(team1);
+    SeasonSnapshot snapshot;
+    snapshot.numTeams = static_cast<int>(teamsByIndex.size());
+    snapshot.preseasonElo = preseasonElo;
 
-    if (team1LostToTeam2 != team1Losses.end() && team2LostToTeam1 != team2Losses.end())
+    for (size_t week = 0; week + 1 < weekGameOffsets.size(); ++week)
     {
-        int team1PointDifferential = team1LostToTeam2->second;
-        int team2PointDifferential = team2LostToTeam1->second;
-
-        // The team that lost by less (i.e., had a smaller point differential) wins
-        if (team1PointDifferential < team2PointDifferential)
-        {
-            return team1;
-        }
-        else if (team2PointDifferential < team1PointDifferential)
+        auto weekResults = std::make_shared<SnapshotWeek>();
+        weekResults->firstGame = weekGameOffsets[week];
+        int numGames = weekGameOffsets[week + 1] - weekGameOffsets[week];
+        weekResults->homeScore.assign(numGames, 0);
+        weekResults->awayScore.assign(numGames, 0);
+        weekResults->complete.assign(numGames, 0);
+        weekResults->odds.assign(numGames, 0.0);
+
+        for (int game = 0; game < numGames; ++game)
         {
-            return team2;
+            const Game &scheduled = *seasonGames[weekResults->firstGame + game];
+            if (scheduled.isGameComplete())
+            {
+                weekResults->complete[game] = 1;
+                weekResults->homeScore[game] = static_cast<int16_t>(scheduled.getHomeTeamScore());
+                weekResults->awayScore[game] = static_cast<int16_t>(scheduled.getAwayTeamScore());
+            }
         }
+        snapshot.weeks.push_back(weekResults);
     }
 
-    // If the teams have not played each other or point differentials are the same, return a random choice
-    return (std::rand() % 2 == 0) ? team1 : team2;
+    replaySnapshot(snapshot, 0);
+    return snapshot;
 }
 
 /**
- * @brief Simulates the playoffs.
+ * @brief Recomputes the Elo ratings, wins and odds of a snapshot from a week on.
  *
- * This function simulates the playoff games for each conference and determines the conference champions.
- * It then simulates the Super Bowl between the AFC and NFC champions.
+ * The weeks from fromWeek on are replaced by updated copies; the weeks before it are
+ * left shared.
+ *
+ * @param snapshot The snapshot to update.
+ * @param fromWeek The first week whose results or preceding ratings changed.
  */
-void NFLSim::simulatePlayoffs()
+void NFLSim::replaySnapshot(SeasonSnapshot &snapshot, int fromWeek) const
 {
-    std::shared_ptr<Team> afcChampion, nfcChampion;
-
-    // Iterate through each conference
-    for (const auto &conferencePair : playoffSeeding)
+    std::array<double, MAX_TEAMS> elo = fromWeek == 0 ? snapshot.preseasonElo : snapshot.weeks[fromWeek - 1]->eloAfter;
+    std::array<float, MAX_TEAMS> wins{};
+    if (fromWeek > 0)
     {
-        const std::string &conference = conferencePair.first;
-        std::vector<std::shared_ptr<Team>> teams = conferencePair.second;
-
-        // Set initial playoff round for each team
-        for (auto &team : teams)
-        {
-            team->setPlayoffRound(1);
-        }
-
-        // First round: 2nd seed vs 7th seed, 3rd seed vs 6th seed, 4th seed vs 5th seed
-        std::vector<std::shared_ptr<Team>> round2;
-        round2.push_back(teams[0]); // Top seed gets a bye
-        round2.push_back(simulatePlayoffGame(teams[1], teams[6]));
-        round2.push_back(simulatePlayoffGame(teams[2], teams[5]));
-        round2.push_back(simulatePlayoffGame(teams[3], teams[4]));
+        wins = snapshot.weeks[fromWeek - 1]->winsAfter;
+    }
 
-        // Update teams' furthest playoff round
-        for (auto &team : round2)
+    for (size_t week = fromWeek; week < snapshot.weeks.size(); ++week)
+    {
+        auto weekResults = std::make_shared<SnapshotWeek>(*snapshot.weeks[week]);
+        for (size_t game = 0; game < weekResults->complete.size(); ++game)
         {
-            team->setPlayoffRound(2);
-        }
+            if (!weekResults->complete[game])
+            {
+                weekResults->odds[game] = 0.0;
+                continue;
+            }
 
-        // Second round: Top seed vs lowest remaining seed, other two teams play each other
-        std::sort(round2.begin() + 1, round2.end(),
-                  [](const std::shared_ptr<Team> &a, const std::shared_ptr<Team> &b)
-                  {
-                      return a->getWinCount() < b->getWinCount();
-                  });
-        std::vector<std::shared_ptr<Team>> round3;
-        round3.push_back(simulatePlayoffGame(round2[0], round2[1]));
-        round3.push_back(simulatePlayoffGame(round2[2], round2[3]));
+            int gameId = weekResults->firstGame + static_cast<int>(game);
+            int homeIndex = seasonGames[gameId]->getHomeTeam()->getScheduleIndex();
+            int awayIndex = seasonGames[gameId]->getAwayTeam()->getScheduleIndex();
+            int homeScore = weekResults->homeScore[game];
+            int awayScore = weekResults->awayScore[game];
 
-        // Update teams' furthest playoff round
-        for (auto &team : round3)
-        {
-            team->setPlayoffRound(3);
-        }
+            double eloDifference = elo[homeIndex] - elo[awayIndex] + travelAdvantage[homeIndex][awayIndex] + gameRestAdjustment[gameId];
+            weekResults->odds[game] = calculateHomeOddsFromEloDiff(eloDifference, config.mathMode);
 
-        // Conference championship
-        std::shared_ptr<Team> conferenceChampion = simulatePlayoffGame(round3[0], round3[1]);
+            double homeEloAdjustment = calculateEloChange(elo[homeIndex], elo[awayIndex], homeScore, awayScore, config.mathMode);
+            elo[homeIndex] += homeEloAdjustment;
+            elo[awayIndex] -= homeEloAdjustment;
 
-        // Store the conference champion for the Super Bowl
-        if (conference == "AFC")
-        {
-            afcChampion = conferenceChampion;
-        }
-        else if (conference == "NFC")
-        {
-            nfcChampion = conferenceChampion;
+            if (homeScore == awayScore)
+            {
+                wins[homeIndex] += 0.5f;
+                wins[awayIndex] += 0.5f;
+            }
+            else
+            {
+                wins[homeScore > awayScore ? homeIndex : awayIndex] += 1;
+            }
         }
 
-        // Update the furthest playoff round for the conference champion
-        conferenceChampion->setPlayoffRound(4);
-    }
-
-    // Super Bowl
-    if (afcChampion && nfcChampion)
-    {
-        std::shared_ptr<Team> superBowlChampion = simulatePlayoffGame(afcChampion, nfcChampion);
-
-        // Update the furthest playoff round for the Super Bowl champion
-        superBowlChampion->setPlayoffRound(5);
+        weekResults->eloAfter = elo;
+        weekResults->winsAfter = wins;
+        snapshot.weeks[week] = weekResults;
     }
 }
 
 /**
- * @brief Simulates a playoff game between two teams.
+ * @brief Sets the result of a team's game in a snapshot.
  *
- * This function creates a new game object for the playoff game, calculates the home team odds,
- * generates random scores, determines the winner, and updates the Elo ratings.
+ * Only the snapshot is changed; the schedule and every snapshot it shares weeks with
+ * keep their results. A score of 0-0 clears the result.
  *
- * @param homeTeam The home team.
- * @param awayTeam The away team.
- * @return The team that wins the playoff game.
+ * @param snapshot The snapshot to change.
+ * @param teamIndex The schedule index of one of the teams.
+ * @param week The week of the game (0-based).
+ * @param homeScore The score of the home team.
+ * @param awayScore The score of the away team.
+ * @return False if the team has no game that week.
  */
-std::shared_ptr<Team> NFLSim::simulatePlayoffGame(std::shared_ptr<Team> homeTeam, std::shared_ptr<Team> awayTeam)
+bool NFLSim::setSnapshotResult(SeasonSnapshot &snapshot, int teamIndex, int week, int homeScore, int awayScore) const
 {
-    // Create a new game object for the playoff game
-    auto game = std::make_shared<Game>(homeTeam, awayTeam);
-
-    // Calculate home odds based on Elo ratings and other factors
-    calculateHomeOdds(game);
-
-    // Initialize the random number generator with a random seed
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
-    std::lognormal_distribution<> scoreDis(1.0, 0.5);
+    if (week < 0 || week >= static_cast<int>(teamGameIds[teamIndex].size()) || teamGameIds[teamIndex][week] < 0)
+    {
+        return false;
+    }
 
-    // Generate a random float between 0 and 1
-    float randomValue = dis(gen);
+    int gameId = teamGameIds[teamIndex][week];
+    int gameWeek = seasonGames[gameId]->getWeekNumber();
+    auto weekResults = std::make_shared<SnapshotWeek>(*snapshot.weeks[gameWeek]);
+    int game = gameId - weekResults->firstGame;
 
-    // Generate scores using a log-linear distribution
-    int score1 = static_cast<int>(3 + 30 * scoreDis(gen));
-    int score2 = static_cast<int>(3 + 30 * scoreDis(gen));
+    bool clear = homeScore == 0 && awayScore == 0;
+    weekResults->complete[game] = clear ? 0 : 1;
+    weekResults->homeScore[game] = static_cast<int16_t>(homeScore);
+    weekResults->awayScore[game] = static_cast<int16_t>(awayScore);
+    snapshot.weeks[gameWeek] = weekResults;
 
-    int winningScore, losingScore;
-    std::shared_ptr<Team> winningTeam, losingTeam;
+    replaySnapshot(snapshot, gameWeek);
+    return true;
+}
 
-    // Ensure that one score is higher than the other
-    winningScore = std::max(score1, score2);
-    losingScore = std::min(score1, score2);
-    if (winningScore == losingScore)
-        winningScore++; // Avoid ties unless specified
+/**
+ * @brief Calculates the home team odds for a game in a season state.
+ * @param state The season state.
+ * @param gameId The id of the game.
+ * @param mode The Elo math to use.
+ * @return The probability of the home team winning.
+ */
+double NFLSim::calculateHomeOdds(const SeasonState &state, int gameId, MathMode mode) const
+{
+    int homeIndex = state.gameHome[gameId];
+    int awayIndex = state.gameAway[gameId];
+    double eloDifference = state.teamElo[homeIndex] - state.teamElo[awayIndex];
+    eloDifference += travelAdvantage[homeIndex][awayIndex] + gameRestAdjustment[gameId];
+    return calculateHomeOddsFromEloDiff(eloDifference, mode);
+}
 
-    // Determine the winning and losing team
-    if (randomValue > game->getHomeTeamOdds())
+/**
+ * @brief Precomputes the score distribution of regular season games.
+ *
+ * Regular season scores are the integer part of a log-normal variable with parameters
+ * 1.0 and 0.5. The score is at least k exactly when the underlying normal variable is
+ * at least (ln k - 1) / 0.5, so storing the normal CDF at those points lets a single
+ * uniform be turned into a score by counting the thresholds below it.
+ * A guide table holds the score at the start of each of scoreGuide.size() equal slices of
+ * [0, 1), so the count only has to continue from there instead of searching all thresholds.
+ * The margin-of-victory logarithms of the Elo update are tabulated alongside, covering
+ * every point difference a regular season game can produce.
+ */
+void NFLSim::buildScoreTable()
+{
+    for (int score = 1; score <= static_cast<int>(scoreThresholds.size()); ++score)
     {
-        game->setAwayTeamScore(winningScore);
-        game->setHomeTeamScore(losingScore);
-        winningTeam = game->getAwayTeam();
-        losingTeam = game->getHomeTeam();
+        double z = (std::log(static_cast<double>(score)) - 1.0) / 0.5;
+        scoreThresholds[score - 1] = 0.5 * std::erfc(-z / std::sqrt(2.0));
     }
-    else
+
+    for (size_t slice = 0; slice < scoreGuide.size(); ++slice)
     {
-        game->setHomeTeamScore(winningScore);
-        game->setAwayTeamScore(losingScore);
-        winningTeam = game->getHomeTeam();
-        losingTeam = game->getAwayTeam();
+        double sliceStart = static_cast<double>(slice) / scoreGuide.size();
+        scoreGuide[slice] = static_cast<uint8_t>(std::upper_bound(scoreThresholds.begin(), scoreThresholds.end(), sliceStart) - scoreThresholds.begin());
     }
 
-    // Mark the game as complete and update Elo ratings
-    game->setGameComplete(true);
-    updateEloRatings(game);
+    for (size_t pointDifference = 0; pointDifference < marginLogarithms.size(); ++pointDifference)
+    {
+        marginLogarithms[pointDifference] = std::log(static_cast<double>(pointDifference) + 1.0);
+    }
+}
+
+/**
+ * @brief Turns a uniform number into a regular season score.
+ * @param randomValue A uniform number in [0, 1).
+ * @return The number of score thresholds at or below the uniform number.
+ */
+int NFLSim::scoreFromUniform(double randomValue) const
+{
+    int score = scoreGuide[static_cast<size_t>(randomValue * scoreGuide.size())];
+    while (score < static_cast<int>(scoreThresholds.size()) && scoreThresholds[score] <= randomValue)
+    {
+        ++score;
+    }
+    return score;
+}
+
+/**
+ * @brief Draws the score of one team in a regular season game.
+ * @param rng The random stream of the season.
+ * @return The score.
+ */
+int NFLSim::drawRegularSeasonScore(SeasonRng &rng) const
+{
+    return scoreFromUniform(rng.nextUniform());
+}
+
+/**
+ * @brief Draws the score of one team in a regular season game in every lane.
+ * @param rng The random streams of the batch.
+ * @return The scores.
+ */
+LaneDouble NFLSim::drawRegularSeasonScores(SeasonRngLanes &rng) const
+{
+    LaneDouble randomValues = rng.nextUniform();
+    LaneDouble scores;
+    for (int lane = 0; lane < SIMD_LANES; ++lane)
+    {
+        scores[lane] = scoreFromUniform(randomValues[lane]);
+    }
+    return scores;
+}
+
+/**
+ * @brief Simulates the regular season games of SIMD_LANES seasons in lockstep.
+ *
+ * This is the batched counterpart of simulateRegularSeason: every game is played in
+ * all lanes at once, with the odds, the outcome, the wins and the Elo update computed
+ * on whole vectors of lanes and only the score lookups done lane by lane. Each lane
+ * makes the same draws and floating point operations as the scalar kernel, so lane i
+ * ends in exactly the state simulateRegularSeason reaches for the season of that lane.
+ * The playoffs are left to the scalar kernel.
+ *
+ * @param run The settings of the run.
+ * @param batch The batch of seasons to simulate, loaded from the initial state.
+ * @param initialState The season state the batch was loaded from.
+ * @param rng The random streams of the batch.
+ */
+void NFLSim::simulateRegularSeasonBatch(const RunConfig &run, SeasonBatch &batch, const SeasonState &initialState, SeasonRngLanes &rng) const
+{
+    const LaneDouble zero = broadcastLanes(0.0);
+    const LaneDouble half = broadcastLanes(0.5);
+    const LaneDouble one = broadcastLanes(1.0);
+    const LaneDouble tieProbability = broadcastLanes(0.01);
+
+    for (size_t week = 0; week + 1 < weekGameOffsets.size(); ++week)
+    {
+        for (int gameId = weekGameOffsets[week]; gameId < weekGameOffsets[week + 1]; ++gameId)
+        {
+            // Skip if the game is already complete; this is the same in every lane
+            if (initialState.gameComplete[gameId])
+                continue;
+
+            int homeIndex = initialState.gameHome[gameId];
+            int awayIndex = initialState.gameAway[gameId];
+            size_t laneOffset = static_cast<size_t>(gameId) * SIMD_LANES;
+
+            // Calculate the odds from the current Elo ratings
+            LaneDouble eloDifference = batch.teamElo[homeIndex] - batch.teamElo[awayIndex];
+            eloDifference += travelAdvantage[homeIndex][awayIndex] + gameRestAdjustment[gameId];
+            LaneDouble homeOdds = EloMath::logistic(eloDifference, run.mathMode);
+            storeLanes(&batch.gameOdds[laneOffset], homeOdds);
+
+            // Expected wins of both teams
+            LaneDouble homeWinProbability = homeOdds - 0.01;
+            homeWinProbability = homeWinProbability > zero ? homeWinProbability : zero;
+            batch.teamExpectedWins[homeIndex] += homeWinProbability + 0.005;
+            batch.teamExpectedWins[awayIndex] += 1.0 - (homeOdds > tieProbability ? homeOdds : tieProbability) + 0.005;
+
+            // Draw the outcome and both scores
+            LaneDouble randomValue = rng.nextUniform();
+            LaneDouble homeScore = drawRegularSeasonScores(rng);
+            LaneDouble awayScore = drawRegularSeasonScores(rng);
+
+            // Ensure that one score is higher than the other unless the game is a tie
+            LaneDouble winningScore = homeScore > awayScore ? homeScore : awayScore;
+            LaneDouble losingScore = homeScore > awayScore ? awayScore : homeScore;
+            winningScore = winningScore == losingScore ? winningScore + 1.0 : winningScore;
+
+            auto tie = randomValue < tieProbability;
+            auto awayWin = randomValue > homeOdds;
+            LaneDouble finalHomeScore = tie ? homeScore : (awayWin ? losingScore : winningScore);
+            LaneDouble finalAwayScore = tie ? homeScore : (awayWin ? winningScore : losingScore);
+
+            batch.teamWins[homeIndex] += tie ? half : (awayWin ? zero : one);
+            batch.teamWins[awayIndex] += tie ? half : (awayWin ? one : zero);
+
+            // Update Elo ratings
+            LaneDouble scoreDifference = finalHomeScore - finalAwayScore;
+            LaneDouble actualResult = scoreDifference > zero ? one : (scoreDifference < zero ? zero : half);
+            LaneDouble marginLog;
+            for (int lane = 0; lane < SIMD_LANES; ++lane)
+            {
+                batch.gameHomeScore[laneOffset + lane] = static_cast<int16_t>(finalHomeScore[lane]);
+                batch.gameAwayScore[laneOffset + lane] = static_cast<int16_t>(finalAwayScore[lane]);
+                marginLog[lane] = marginLogarithms[static_cast<int>(std::abs(scoreDifference[lane]))];
+            }
+
+            LaneDouble homeEloAdjustment = EloMath::eloChange(batch.teamElo[homeIndex] - batch.teamElo[awayIndex], actualResult, marginLog, run.mathMode);
+            batch.teamElo[homeIndex] += homeEloAdjustment;
+            batch.teamElo[awayIndex] -= homeEloAdjustment;
+        }
+    }
+}
+
+/**
+ * @brief Simulates the regular season games.
+ *
+ * This function iterates week by week through each game in the season state that has
+ * not been played yet, generating random scores and determining the outcome of each game.
+ * The odds of a game are calculated from the teams' current Elo ratings right before
+ * it is played. Finally, it determines the playoff teams and simulates the playoffs.
+ *
+ * @param run The settings of the run.
+ * @param state The season state to simulate.
+ * @param rng The random stream of the season.
+ */
+void NFLSim::simulateRegularSeason(const RunConfig &run, SeasonState &state, SeasonRng &rng) const
+{
+    // Play the games week by week
+    for (size_t week = 0; week + 1 < weekGameOffsets.size(); ++week)
+    {
+        for (int gameId = weekGameOffsets[week]; gameId < weekGameOffsets[week + 1]; ++gameId)
+        {
+            // Skip if the game is already complete
+            if (state.gameComplete[gameId])
+                continue;
+
+            int homeIndex = state.gameHome[gameId];
+            int awayIndex = state.gameAway[gameId];
+
+            // Calculate the odds from the current Elo ratings
+            double homeOdds = calculateHomeOdds(state, gameId, run.mathMode);
+            state.gameOdds[gameId] = homeOdds;
+
+            // Expected wins of both teams; a random value below 0.01 is a tie worth half a win
+            state.teamExpectedWins[homeIndex] += std::max(homeOdds - 0.01, 0.0) + 0.005;
+            state.teamExpectedWins[awayIndex] += 1.0 - std::max(homeOdds, 0.01) + 0.005;
+
+            // With importance sampling the outcome is drawn from odds tilted toward the target
+            double drawOdds = run.importanceTeam >= 0 ? tiltHomeOdds(run, homeOdds, homeIndex, awayIndex) : homeOdds;
+
+            // Generate a random number between 0 and 1
+            double randomValue = rng.nextUniform();
+
+            // Generate scores using a log-normal distribution
+            int homeScore = drawRegularSeasonScore(rng);
+            int awayScore = drawRegularSeasonScore(rng);
+
+            // Determine if the game ends in a tie
+            if (randomValue < 0.01)
+            {
+                awayScore = homeScore; // Both teams get the same score
+                state.teamWins[homeIndex] += 0.5f;
+                state.teamWins[awayIndex] += 0.5f;
+            }
+            else
+            {
+                // Ensure that one score is higher than the other
+                int winningScore = std::max(homeScore, awayScore);
+                int losingScore = std::min(homeScore, awayScore);
+                if (winningScore == losingScore)
+                    winningScore++; // Avoid ties unless specified
+
+                // Determine the winning and losing team; ties have the same probability either way
+                if (randomValue > drawOdds)
+                {
+                    awayScore = winningScore;
+                    homeScore = losingScore;
+                    state.teamWins[awayIndex] += 1;
+                    if (run.importanceTeam >= 0)
+                        state.weight *= (1.0 - std::max(homeOdds, 0.01)) / (1.0 - std::max(drawOdds, 0.01));
+                }
+                else
+                {
+                    homeScore = winningScore;
+                    awayScore = losingScore;
+                    state.teamWins[homeIndex] += 1;
+                    if (run.importanceTeam >= 0)
+                        state.weight *= std::max(homeOdds - 0.01, 0.0) / (drawOdds - 0.01);
+                }
+            }
+
+            // Mark the game as complete, record it for the tiebreakers and update Elo ratings
+            state.gameHomeScore[gameId] = static_cast<int16_t>(homeScore);
+            state.gameAwayScore[gameId] = static_cast<int16_t>(awayScore);
+            state.gameComplete[gameId] = 1;
+            state.recordResult(gameId);
+            updateEloRatings(state, homeIndex, awayIndex, homeScore, awayScore, run.mathMode);
+        }
+    }
+
+    // Determine the playoff teams and simulate the playoffs
+    determinePlayoffTeams(state, rng);
+    simulatePlayoffs(run, state, rng);
+}
+
+/**
+ * @brief Determines the playoff teams.
+ *
+ * This function determines the division winners and wildcard teams of every
+ * conference and stores them as the playoff seeding of the season state.
+ *
+ * @param state The season state.
+ * @param rng The random stream of the season.
+ */
+void NFLSim::determinePlayoffTeams(SeasonState &state, SeasonRng &rng) const
+{
+    for (size_t conference = 0; conference < conferenceDivisions.size() && conference < NUM_CONFERENCES; ++conference)
+    {
+        int numSeeded = determineDivisionWinners(state, rng, static_cast<int>(conference));
+        determineWildCardTeams(state, rng, static_cast<int>(conference), numSeeded);
+    }
+}
+
+/**
+ * @brief Determines the division winners of a conference.
+ *
+ * Each division is won by its best team under the division tiebreakers, and the
+ * division winners take the top seeds of the conference in the order of the wildcard
+ * tiebreakers.
+ *
+ * @param state The season state.
+ * @param rng The random stream of the season.
+ * @param conference The index of the conference.
+ * @return The number of division winners seeded.
+ */
+int NFLSim::determineDivisionWinners(SeasonState &state, SeasonRng &rng, int conference) const
+{
+    TeamGroup winners;
+    for (const auto &division : conferenceDivisions[conference])
+    {
+        if (division.empty())
+            continue;
+
+        TeamGroup teams;
+        for (int team : division)
+        {
+            teams.add(team);
+        }
+        winners.add(pickBestTeam(state, rng, teams, true));
+    }
+
+    // Seed the division winners best first
+    int numSeeded = 0;
+    while (winners.size > 0 && numSeeded < PLAYOFF_TEAMS)
+    {
+        int team = pickBestTeam(state, rng, winners, false);
+        state.playoffSeeds[conference][numSeeded++] = static_cast<int8_t>(team);
+        winners.remove(team);
+    }
+    return numSeeded;
+}
+
+/**
+ * @brief Determines the wildcard teams of a conference.
+ *
+ * The remaining playoff spots go to the best teams that did not win their division,
+ * picked one at a time under the wildcard tiebreakers, so the teams still tied after
+ * a pick start the procedure over.
+ *
+ * @param state The season state.
+ * @param rng The random stream of the season.
+ * @param conference The index of the conference.
+ * @param numSeeded The number of division winners already seeded.
+ */
+void NFLSim::determineWildCardTeams(SeasonState &state, SeasonRng &rng, int conference, int numSeeded) const
+{
+    const auto &seeds = state.playoffSeeds[conference];
+
+    // Get all teams excluding division winners
+    TeamGroup candidates;
+    for (const auto &division : conferenceDivisions[conference])
+    {
+        for (int team : division)
+        {
+            if (std::find(seeds.begin(), seeds.begin() + numSeeded, team) == seeds.begin() + numSeeded)
+            {
+                candidates.add(team);
+            }
+        }
+    }
+
+    while (candidates.size > 0 && numSeeded < PLAYOFF_TEAMS)
+    {
+        int team = pickBestTeam(state, rng, candidates, false);
+        state.playoffSeeds[conference][numSeeded++] = static_cast<int8_t>(team);
+        candidates.remove(team);
+    }
+}
+
+/**
+ * @brief Picks the best team of a group by record, breaking ties.
+ *
+ * For a division title the division tiebreakers decide between the teams tied for the
+ * best record. Otherwise a tie between teams of the same division is first reduced to
+ * the one the division tiebreakers rank highest, and the wildcard tiebreakers decide
+ * between the remaining teams of different divisions.
+ *
+ * @param state The season state.
+ * @param rng The random stream of the season, for coin tosses.
+ * @param candidates The teams to pick from.
+ * @param withinDivision Whether all candidates belong to one division.
+ * @return The schedule index of the best team.
+ */
+int NFLSim::pickBestTeam(const SeasonState &state, SeasonRng &rng, const TeamGroup &candidates, bool withinDivision) const
+{
+    float bestWins = state.teamWins[candidates.teams[0]];
+    for (int i = 1; i < candidates.size; ++i)
+    {
+        bestWins = std::max(bestWins, state.teamWins[candidates.teams[i]]);
+    }
+
+    TeamGroup tied;
+    for (int i = 0; i < candidates.size; ++i)
+    {
+        if (state.teamWins[candidates.teams[i]] == bestWins)
+        {
+            tied.add(candidates.teams[i]);
+        }
+    }
+    if (tied.size == 1 || withinDivision)
+    {
+        return breakTie(state, rng, tied, false);
+    }
+
+    // Keep only the highest ranked team of every division
+    TeamGroup leaders;
+    for (int i = 0; i < tied.size; ++i)
+    {
+        int division = teamDivision[tied.teams[i]];
+        bool divisionDone = false;
+        for (int j = 0; j < i && !divisionDone; ++j)
+        {
+            divisionDone = teamDivision[tied.teams[j]] == division;
+        }
+        if (divisionDone)
+            continue;
+
+        TeamGroup rivals;
+        for (int j = i; j < tied.size; ++j)
+        {
+            if (teamDivision[tied.teams[j]] == division)
+            {
+                rivals.add(tied.teams[j]);
+            }
+        }
+        leaders.add(breakTie(state, rng, rivals, false));
+    }
+    return breakTie(state, rng, leaders, true);
+}
+
+/**
+ * @brief Breaks a tie between teams with the same record.
+ *
+ * The steps of the NFL procedure are tried in order, and each keeps only the teams with
+ * the best value. As soon as a step eliminates a team, the remaining teams start over
+ * from the first step. Division ties go by head-to-head, division, common games and
+ * conference records, then strength of victory and of schedule; wildcard ties by
+ * head-to-head, conference and common games records, then strength of victory and of
+ * schedule. A coin toss decides what none of the steps can.
+ *
+ * @param state The season state.
+ * @param rng The random stream of the season, for coin tosses.
+ * @param tied The tied teams.
+ * @param wildCard Whether the wildcard procedure applies instead of the division one.
+ * @return The schedule index of the team that wins the tiebreaker.
+ */
+int NFLSim::breakTie(const SeasonState &state, SeasonRng &rng, TeamGroup tied, bool wildCard) const
+{
+    static const TiebreakStep DIVISION_STEPS[] = {TiebreakStep::HeadToHead, TiebreakStep::DivisionRecord, TiebreakStep::CommonGames,
+                                                  TiebreakStep::ConferenceRecord, TiebreakStep::StrengthOfVictory,
+                                                  TiebreakStep::StrengthOfSchedule};
+    static const TiebreakStep WILD_CARD_STEPS[] = {TiebreakStep::HeadToHead, TiebreakStep::ConferenceRecord, TiebreakStep::CommonGames,
+                                                   TiebreakStep::StrengthOfVictory, TiebreakStep::StrengthOfSchedule};
+
+    const TiebreakStep *steps = wildCard ? WILD_CARD_STEPS : DIVISION_STEPS;
+    const int numSteps = wildCard ? std::size(WILD_CARD_STEPS) : std::size(DIVISION_STEPS);
+
+    while (tied.size > 1)
+    {
+        bool eliminated = false;
+        for (int step = 0; step < numSteps && !eliminated; ++step)
+        {
+            eliminated = applyTiebreakStep(state, tied, steps[step], wildCard);
+        }
+
+        if (!eliminated)
+        {
+            int winner = static_cast<int>(rng.nextUniform() * tied.size);
+            return tied.teams[std::min(winner, tied.size - 1)];
+        }
+    }
+    return tied.teams[0];
+}
+
+/**
+ * @brief Applies one step of a tiebreaker procedure.
+ *
+ * Records are compared as winning percentages with ties counting half. Common games are
+ * the games against opponents every tied team played; the wildcard procedure requires
+ * at least four of them per team. Strength of victory is the combined record of the
+ * opponents a team beat, strength of schedule that of all its opponents, counted once
+ * per game. In a wildcard tie of more than two teams, head-to-head only applies as a
+ * sweep: a team that beat all others wins, and a team that lost to all others is out.
+ *
+ * @param state The season state.
+ * @param tied The tied teams; reduced to the teams with the best value.
+ * @param step The step to apply.
+ * @param wildCard Whether the tie is broken with the wildcard procedure.
+ * @return True if the step eliminated at least one team.
+ */
+bool NFLSim::applyTiebreakStep(const SeasonState &state, TeamGroup &tied, TiebreakStep step, bool wildCard) const
+{
+    if (step == TiebreakStep::HeadToHead && wildCard && tied.size > 2)
+    {
+        TeamGroup remaining;
+        for (int i = 0; i < tied.size; ++i)
+        {
+            bool beatAll = true;
+            bool lostToAll = true;
+            for (int j = 0; j < tied.size; ++j)
+            {
+                if (i == j)
+                    continue;
+                const HeadToHeadRecord &record = state.headToHead.against(tied.teams[i], tied.teams[j]);
+                beatAll = beatAll && record.wins > 0 && record.losses == 0 && record.ties == 0;
+                lostToAll = lostToAll && record.losses > 0 && record.wins == 0 && record.ties == 0;
+            }
+            if (beatAll)
+            {
+                tied.size = 1;
+                tied.teams[0] = tied.teams[i];
+                return true;
+            }
+            if (!lostToAll)
+            {
+                remaining.add(tied.teams[i]);
+            }
+        }
+        if (remaining.size == tied.size || remaining.size == 0)
+        {
+            return false;
+        }
+        tied = remaining;
+        return true;
+    }
+
+    // Record of a team against a set of opponents, as half wins and twice the games
+    auto addRecord = [&state](int team, uint32_t opponentSet, long long &halfWins, long long &doubleGames)
+    {
+        for (uint32_t remaining = opponentSet & state.headToHead.opponents[team]; remaining != 0; remaining &= remaining - 1)
+        {
+            const HeadToHeadRecord &record = state.headToHead.against(team, __builtin_ctz(remaining));
+            halfWins += 2 * record.wins + record.ties;
+            doubleGames += 2 * (record.wins + record.losses + record.ties);
+        }
+    };
+
+    // The tied teams, and the opponents every one of them played for the common games
+    uint32_t tiedTeams = 0;
+    uint32_t common = ~0u;
+    for (int i = 0; i < tied.size; ++i)
+    {
+        tiedTeams |= 1u << tied.teams[i];
+        common &= state.headToHead.opponents[tied.teams[i]];
+    }
+    common &= ~tiedTeams;
+
+    // Value of every tied team as a fraction; a step without games for every team does not apply
+    std::array<double, MAX_TEAMS> values;
+    double best = 0.0;
+    for (int i = 0; i < tied.size; ++i)
+    {
+        const int team = tied.teams[i];
+        long long numerator = 0;
+        long long denominator = 0;
+        switch (step)
+        {
+        case TiebreakStep::HeadToHead:
+            addRecord(team, tiedTeams, numerator, denominator);
+            break;
+        case TiebreakStep::DivisionRecord:
+            addRecord(team, divisionRivals[team], numerator, denominator);
+            break;
+        case TiebreakStep::ConferenceRecord:
+            addRecord(team, conferenceRivals[team], numerator, denominator);
+            break;
+        case TiebreakStep::CommonGames:
+            addRecord(team, common, numerator, denominator);
+            if (wildCard && denominator < 2 * 4)
+            {
+                return false;
+            }
+            break;
+        case TiebreakStep::StrengthOfVictory:
+        case TiebreakStep::StrengthOfSchedule:
+            for (uint32_t remaining = state.headToHead.opponents[team]; remaining != 0; remaining &= remaining - 1)
+            {
+                int opponent = __builtin_ctz(remaining);
+                const HeadToHeadRecord &record = state.headToHead.against(team, opponent);
+                int games = step == TiebreakStep::StrengthOfVictory ? record.wins : record.wins + record.losses + record.ties;
+                numerator += games * static_cast<long long>(2 * state.teamWins[opponent]);
+                denominator += games;
+            }
+            // Every team plays the same number of games, so the opponents' wins stand for their records
+            if (denominator == 0)
+            {
+                numerator = 0;
+                denominator = 1;
+            }
+            break;
+        }
+        if (denominator == 0)
+        {
+            return false;
+        }
+        values[i] = static_cast<double>(numerator) / static_cast<double>(denominator);
+        best = std::max(best, values[i]);
+    }
+
+    // Keep the teams with the best value
+    int kept = 0;
+    for (int i = 0; i < tied.size; ++i)
+    {
+        if (values[i] == best)
+        {
+            tied.teams[kept++] = tied.teams[i];
+        }
+    }
+    bool eliminated = kept < tied.size;
+    tied.size = kept;
+    return eliminated;
+}
+
+/**
+ * @brief Simulates the playoffs.
+ *
+ * This function simulates the playoff games for each conference and determines the conference champions.
+ * It then simulates the Super Bowl between the AFC and NFC champions.
+ *
+ * @param run The settings of the run.
+ * @param state The season state with the playoff seeding.
+ * @param rng The random stream of the season.
+ */
+void NFLSim::simulatePlayoffs(const RunConfig &run, SeasonState &state, SeasonRng &rng) const
+{
+    int numConferences = std::min(static_cast<int>(conferenceDivisions.size()), NUM_CONFERENCES);
+    std::array<int, NUM_CONFERENCES> champions{};
+
+    for (int conference = 0; conference < numConferences; ++conference)
+    {
+        const auto &teams = state.playoffSeeds[conference];
+
+        // Set initial playoff round for each team
+        for (int team : teams)
+        {
+            state.playoffRound[team] = 1;
+        }
+
+        // First round: 2nd seed vs 7th seed, 3rd seed vs 6th seed, 4th seed vs 5th seed
+        std::array<int, 4> round2 = {teams[0], // Top seed gets a bye
+                                     simulatePlayoffGame(run, state, rng, teams[1], teams[6]),
+                                     simulatePlayoffGame(run, state, rng, teams[2], teams[5]),
+                                     simulatePlayoffGame(run, state, rng, teams[3], teams[4])};
+
+        // Update teams' furthest playoff round
+        for (int team : round2)
+        {
+            state.playoffRound[team] = 2;
+        }
+
+        // Second round: Top seed vs lowest remaining seed, other two teams play each other
+        auto seedOf = [&teams](int team)
+        {
+            return std::find(teams.begin(), teams.end(), team) - teams.begin();
+        };
+        std::sort(round2.begin() + 1, round2.end(), [&seedOf](int a, int b)
+                  { return seedOf(a) > seedOf(b); });
+        std::array<int, 2> round3 = {simulatePlayoffGame(run, state, rng, round2[0], round2[1]),
+                                     simulatePlayoffGame(run, state, rng, round2[3], round2[2])};
+
+        // Update teams' furthest playoff round
+        for (int team : round3)
+        {
+            state.playoffRound[team] = 3;
+        }
+
+        // Conference championship
+        champions[conference] = simulatePlayoffGame(run, state, rng, round3[0], round3[1]);
+
+        // Update the furthest playoff round for the conference champion
+        state.playoffRound[champions[conference]] = 4;
+    }
+
+    // Super Bowl between the AFC and NFC champions
+    if (numConferences == NUM_CONFERENCES)
+    {
+        int superBowlChampion = simulatePlayoffGame(run, state, rng, champions[0], champions[1]);
+
+        // Update the furthest playoff round for the Super Bowl champion
+        state.playoffRound[superBowlChampion] = 5;
+    }
+}
+
+/**
+ * @brief Simulates a playoff game between two teams.
+ *
+ * This function calculates the home team odds, generates random scores, determines
+ * the winner, and updates the Elo ratings in the season state.
+ *
+ * @param run The settings of the run.
+ * @param state The season state.
+ * @param rng The random stream of the season.
+ * @param homeIndex The schedule index of the home team.
+ * @param awayIndex The schedule index of the away team.
+ * @return The schedule index of the team that wins the playoff game.
+ */
+int NFLSim::simulatePlayoffGame(const RunConfig &run, SeasonState &state, SeasonRng &rng, int homeIndex, int awayIndex) const
+{
+    // Calculate home odds based on Elo ratings and the travel advantage of the home team
+    double eloDifference = state.teamElo[homeIndex] - state.teamElo[awayIndex] + travelAdvantage[homeIndex][awayIndex];
+    double homeOdds = calculateHomeOddsFromEloDiff(eloDifference, run.mathMode);
+    double drawOdds = run.importanceTeam >= 0 ? tiltHomeOdds(run, homeOdds, homeIndex, awayIndex) : homeOdds;
+
+    // Generate a random number between 0 and 1
+    double randomValue = rng.nextUniform();
+
+    // Generate scores using a log-linear distribution; Box-Muller turns two uniforms into two normals
+    double radius = std::sqrt(-2.0 * std::log(1.0 - rng.nextUniform()));
+    double angle = 2.0 * M_PI * rng.nextUniform();
+    int score1 = static_cast<int>(3 + 30 * std::exp(1.0 + 0.5 * radius * std::cos(angle)));
+    int score2 = static_cast<int>(3 + 30 * std::exp(1.0 + 0.5 * radius * std::sin(angle)));
+
+    // Ensure that one score is higher than the other
+    int winningScore = std::max(score1, score2);
+    int losingScore = std::min(score1, score2);
+    if (winningScore == losingScore)
+        winningScore++; // Avoid ties unless specified
+
+    // Determine the winning team, reweight for importance sampling and update Elo ratings
+    if (randomValue > drawOdds)
+    {
+        if (run.importanceTeam >= 0)
+            state.weight *= (1.0 - homeOdds) / (1.0 - drawOdds);
+        updateEloRatings(state, homeIndex, awayIndex, losingScore, winningScore, run.mathMode);
+        return awayIndex;
+    }
+
+    if (run.importanceTeam >= 0)
+        state.weight *= homeOdds / drawOdds;
+    updateEloRatings(state, homeIndex, awayIndex, winningScore, losingScore, run.mathMode);
+    return homeIndex;
+}
+
+/**
+ * @brief Simulates multiple NFL seasons and prints the results.
+ *
+ * With a checkpoint file, the progress of the run is saved periodically so it can be resumed.
+ *
+ * @param numSeasons The number of seasons to simulate.
+ * @param print Whether to print the schedule after each season.
+ */
+void NFLSim::simulateMultipleSeasons(int numSeasons, bool print)
+{
+    RunCheckpoint checkpoint;
+    checkpoint.seed = config.seed;
+    checkpoint.leagueFingerprint = leagueFingerprint(buildSeasonState());
+    checkpoint.modelFingerprint = modelFingerprint;
+    checkpoint.targetSeasons = numSeasons;
+    checkpoint.mathMode = config.mathMode;
+    checkpoint.antithetic = config.antithetic;
+    checkpoint.controlVariates = config.controlVariates;
+    checkpoint.importanceTeam = config.importanceTeam;
+    checkpoint.importanceTilt = config.importanceTilt;
+
+    continueRun(checkpoint, print);
+}
+
+/**
+ * @brief Resumes the run saved in the resume checkpoint.
+ *
+ * The seed and simulation options are taken from the checkpoint, and the league and model must be
+ * the ones the run started from. Progress keeps being saved to the checkpoint file, or to
+ * the resumed file if none was given.
+ */
+void NFLSim::resumeRun()
+{
+    RunCheckpoint checkpoint;
+    if (!checkpoint.load(resumeFile))
+    {
+        failed = true;
+        return;
+    }
+
+    if (checkpoint.leagueFingerprint != leagueFingerprint(buildSeasonState()) ||
+        checkpoint.importanceTeam >= static_cast<int>(teamsByIndex.size()))
+    {
+        std::cerr << "Error: Checkpoint " << resumeFile << " was saved for a different schedule" << std::endl;
+        failed = true;
+        return;
+    }
+    if (checkpoint.modelFingerprint != modelFingerprint)
+    {
+        std::cerr << "Error: Checkpoint " << resumeFile << " was saved with different teams or simulation model" << std::endl;
+        failed = true;
+        return;
+    }
+
+    config.seed = checkpoint.seed;
+    config.mathMode = checkpoint.mathMode;
+    config.antithetic = checkpoint.antithetic;
+    config.controlVariates = checkpoint.controlVariates;
+    config.importanceTeam = checkpoint.importanceTeam;
+    config.setImportanceTilt(checkpoint.importanceTilt);
+    if (checkpointFile.empty())
+    {
+        checkpointFile = resumeFile;
+    }
+
+    std::cout << "Resuming at season " << checkpoint.completedSeasons << " of " << checkpoint.targetSeasons << std::endl;
+    continueRun(checkpoint, false);
+}
+
+/**
+ * @brief Simulates the seasons a run has not completed yet and prints its results.
+ *
+ * With a checkpoint file the seasons are simulated in chunks of checkpointInterval and the
+ * progress is saved after every chunk. Every season keeps its index, so the chunks add up
+ * to exactly the results of a single uninterrupted run.
+ *
+ * @param checkpoint The run, with the results of the seasons completed so far.
+ * @param print Whether to print the schedule after each season.
+ */
+void NFLSim::continueRun(RunCheckpoint &checkpoint, bool print)
+{
+    // Results go to the output file if one was given; open it before the long part
+    std::ofstream outputStream;
+    if (!outputFile.empty())
+    {
+        outputStream.open(outputFile);
+        if (!outputStream.is_open())
+        {
+            std::cerr << "Error: Could not open file " << outputFile << " for writing." << std::endl;
+            failed = true;
+            return;
+        }
+    }
+    std::ostream &out = outputFile.empty() ? std::cout : outputStream;
+
+    const SeasonState initialState = buildSeasonState();
+    if (!startTrace(initialState))
+    {
+        failed = true;
+        return;
+    }
+
+    while (checkpoint.completedSeasons < checkpoint.targetSeasons)
+    {
+        long long remaining = checkpoint.targetSeasons - checkpoint.completedSeasons;
+        int chunk = static_cast<int>(checkpointFile.empty() ? remaining : std::min<long long>(remaining, checkpointInterval));
+
+        checkpoint.tally.merge(runSeasons(initialState, static_cast<int>(checkpoint.completedSeasons), chunk, print));
+        checkpoint.completedSeasons += chunk;
+
+        if (!checkpointFile.empty() && !checkpoint.save(checkpointFile))
+        {
+            finishTrace();
+            failed = true;
+            return;
+        }
+    }
+
+    if (!finishTrace())
+    {
+        failed = true;
+    }
+
+    // Print the final results in a table format
+    out << "Seed: " << config.seed << std::endl;
+    printFinalResults(checkpoint.tally, false, out);
+    reportDistributions(checkpoint.tally, out);
+}
+
+/**
+ * @brief Hashes the parts of a season state and the league layout that determine a run's results.
+ * @param state The initial season state of the run.
+ * @return The fingerprint of the teams' ratings, the schedule with its results and the
+ *         conferences and divisions.
+ */
+uint64_t NFLSim::leagueFingerprint(const SeasonState &state) const
+{
+    Fingerprint fingerprint;
+    fingerprint.add(state.numTeams);
+    fingerprint.add(state.teamElo);
+    fingerprint.add(state.teamWins);
+    fingerprint.add(state.numGames);
+    fingerprint.add(state.gameHome);
+    fingerprint.add(state.gameAway);
+    fingerprint.add(state.gameWeek);
+    fingerprint.add(state.gameHomeScore);
+    fingerprint.add(state.gameAwayScore);
+    fingerprint.add(state.gameComplete);
+
+    // Divisions and conferences decide the playoff seeding
+    fingerprint.add(teamDivision);
+    fingerprint.add(divisionRivals);
+    fingerprint.add(conferenceRivals);
+    fingerprint.add(conferenceDivisions.size());
+    for (const auto &divisions : conferenceDivisions)
+    {
+        fingerprint.add(divisions.size());
+        for (const auto &division : divisions)
+        {
+            fingerprint.add(division);
+        }
+    }
+    return fingerprint.hash;
+}
+
+/**
+ * @brief Simulates seasons until every reported playoff probability reaches a target precision.
+ *
+ * Seasons are simulated in rounds. After each round the widest 95% confidence interval of
+ * any team's wildcard, divisional, conference, Super Bowl or championship probability is
+ * compared against the target. The next round is sized from how far off that interval is,
+ * since the half-width shrinks with the square root of the number of seasons, but never
+ * more than doubles the seasons run so far. Rounds continue the season indices of the
+ * previous ones, so the result is the same as a fixed run of the final season count.
+ *
+ * @param targetHalfWidth The target half-width as a probability (0.0025 for 0.25 points).
+ */
+void NFLSim::simulateUntilConfident(double targetHalfWidth)
+{
+    const int MIN_ROUND_SEASONS = 1000;
+    const int MAX_SEASONS = 50000000;
+
+    const SeasonState initialState = buildSeasonState();
+    SeasonTally total;
+    int seasonsRun = 0;
+    double widest = 1.0;
+    if (!startTrace(initialState))
+    {
+        failed = true;
+        return;
+    }
+
+    while (seasonsRun < MAX_SEASONS)
+    {
+        // Estimate the seasons still needed from the current widest interval
+        int roundSeasons = MIN_ROUND_SEASONS;
+        if (seasonsRun > 0)
+        {
+            double ratio = widest / targetHalfWidth;
+            double needed = seasonsRun * ratio * ratio - seasonsRun;
+            roundSeasons = static_cast<int>(std::min(std::max(needed, static_cast<double>(MIN_ROUND_SEASONS)), static_cast<double>(seasonsRun)));
+        }
+        roundSeasons = std::min(roundSeasons, MAX_SEASONS - seasonsRun);
+
+        total.merge(runSeasons(initialState, seasonsRun, roundSeasons, false));
+        seasonsRun += roundSeasons;
+
+        // With importance sampling only the target team's estimates are tracked
+        widest = 0.0;
+        for (const auto &team : teamsByIndex)
+        {
+            if (config.importanceTeam >= 0 && team->getScheduleIndex() != config.importanceTeam)
+                continue;
+
+            for (int round = 1; round < NUM_PLAYOFF_ROUNDS; ++round)
+            {
+                widest = std::max(widest, total.halfWidth(team->getScheduleIndex(), round, config.estimator()));
+            }
+        }
+
+        if (widest <= targetHalfWidth)
+        {
+            break;
+        }
+    }
+    if (!finishTrace())
+    {
+        failed = true;
+    }
+
+    std::cout << "Seed: " << config.seed << std::endl;
+    printFinalResults(total, true, std::cout);
+    reportDistributions(total, std::cout);
+    std::cout << "Seasons simulated: " << total.seasons << ", widest 95% interval: +/- "
+              << std::fixed << std::setprecision(3) << widest * 100.0 << " points (target +/- "
+              << targetHalfWidth * 100.0 << ")" << std::endl;
+    if (widest > targetHalfWidth)
+    {
+        std::cout << "Stopped at " << MAX_SEASONS << " seasons before reaching the target." << std::endl;
+    }
+}
 
-    return winningTeam;
+/**
+ * @brief Simulates seasons with the settings given on the command line.
+ * @param initialState The season state every season starts from.
+ * @param firstSeason The index of the first season, which selects its random stream.
+ * @param numSeasons The number of seasons to simulate.
+ * @param print Whether to print the schedule after each season.
+ * @return The merged results of all simulated seasons.
+ */
+SeasonTally NFLSim::runSeasons(const SeasonState &initialState, int firstSeason, int numSeasons, bool print) const
+{
+    return runSeasons(config, initialState, firstSeason, numSeasons, print);
 }
 
 /**
  * @brief Simulates multiple NFL seasons and records the results.
  *
- * This function simulates a specified number of NFL seasons, recording the number of wins
- * and playoff rounds reached by each team in each season. It then prints the results for
- * each season and the final results in a table format.
+ * This function simulates a specified number of NFL seasons on the configured number of
+ * worker threads. Every worker owns a season state that is reset from the initial state
+ * before each season, and records the wins and playoff rounds reached by each team into
+ * its own tally; the tallies are merged once all seasons are done. Every season draws
+ * from its own random stream keyed by the seed and the season index, so the results do
+ * not depend on the number of workers.
+ * Regular seasons are simulated SIMD_LANES at a time by the batched kernel, which
+ * produces exactly the seasons the scalar kernel would.
+ * Printing the schedule after every season forces a single worker. With a trace open,
+ * every worker encodes its seasons into a trace block of its own.
  *
+ * @param run The settings of the run.
+ * @param initialState The season state every season starts from.
+ * @param firstSeason The index of the first season, which selects its random stream.
  * @param numSeasons The number of seasons to simulate.
+ * @param print Whether to print the schedule after each season.
+ * @return The merged results of all simulated seasons.
  */
-void NFLSim::simulateMultipleSeasons(int numSeasons, bool print)
+SeasonTally NFLSim::runSeasons(const RunConfig &run, const SeasonState &initialState, int firstSeason, int numSeasons, bool print) const
 {
-    // Data structures to keep track of wins and playoff rounds for each team across seasons
-    std::map<std::string, std::vector<int>> teamWins;
-    std::map<std::string, std::vector<int>> playoffRounds;
+    // Identical runs give identical results, so reuse them unless the seasons are printed or traced
+    uint64_t key = runKey(run, initialState, firstSeason, numSeasons);
+    SeasonTally cached;
+    if (!print && !seasonTrace && resultCache->lookup(key, cached))
+    {
+        return cached;
+    }
 
-    // Initialize the win counts and playoff rounds for each team
-    for (const auto &teamPair : teamMapByAbbreviation)
+    int workers = print ? 1 : std::min(run.numThreads, std::max(1, numSeasons));
+    MonteCarloEngine engine(workers);
+
+    std::vector<SeasonState> states(workers, initialState);
+    std::vector<SeasonTally> tallies(workers);
+    std::vector<SeasonBatch> batches(workers);
+    std::vector<SeasonTraceBlock> traceBlocks(seasonTrace ? workers : 0);
+
+    // Printing goes through a copy of the league so the view itself stays untouched
+    std::unique_ptr<NFLSim> printView;
+    if (print)
     {
-        teamWins[teamPair.first] = std::vector<int>(numSeasons, 0);
-        playoffRounds[teamPair.first] = std::vector<int>(numSeasons, 0);
+        printView.reset(new NFLSim(*this));
     }
 
-    // Simulate each season
-    for (int season = 0; season < numSeasons; ++season)
+    // Records a simulated season, and traces and prints it if requested
+    auto finishSeason = [&](int worker, int season, const SeasonState &state)
     {
-        // Simulate the regular season
-        simulateRegularSeason();
+        recordSeason(state, tallies[worker]);
 
-        // Record the number of wins and playoff rounds for each team
-        for (const auto &teamPair : teamMapByAbbreviation)
+        if (seasonTrace)
         {
-            teamWins[teamPair.first][season] = teamPair.second->getWinCount();
-            playoffRounds[teamPair.first][season] = teamPair.second->getPlayoffRound();
+            seasonTrace->record(traceBlocks[worker], season, state);
         }
 
         if (print)
         {
-            printSchedule();
+            printView->applySeasonState(state);
+            printView->printSchedule();
         }
+    };
 
-        // Reset the season for the next simulation
-        resetSeason();
+    engine.run(numSeasons, [&](int worker, int first, int last)
+               {
+                   SeasonState &state = states[worker];
+                   SeasonBatch &batch = batches[worker];
+                   int season = firstSeason + first;
+                   int lastSeason = firstSeason + last;
+
+                   // Simulate full groups of SIMD_LANES seasons with the batched kernel,
+                   // then finish each lane's playoffs on its own random stream.
+                   // Importance sampling reweights single draws, so it stays on the scalar kernel.
+                   for (; run.importanceTeam < 0 && season + SIMD_LANES <= lastSeason; season += SIMD_LANES)
+                   {
+                       batch.load(initialState);
+                       SeasonRngLanes laneRng(run.seed, season, run.antithetic);
+                       simulateRegularSeasonBatch(run, batch, initialState, laneRng);
+
+                       for (int lane = 0; lane < SIMD_LANES; ++lane)
+                       {
+                           state = initialState;
+                           batch.extractLane(lane, state);
+                           SeasonRng rng(run.seed, season + lane, run.antithetic);
+                           rng.seek(laneRng.getDrawIndex());
+                           determinePlayoffTeams(state, rng);
+                           simulatePlayoffs(run, state, rng);
+                           finishSeason(worker, season + lane, state);
+                       }
+                   }
+
+                   // Simulate the remaining seasons one at a time
+                   for (; season < lastSeason; ++season)
+                   {
+                       // Reset the season state and simulate the season with its own random stream
+                       state = initialState;
+                       SeasonRng rng(run.seed, season, run.antithetic);
+                       simulateRegularSeason(run, state, rng);
+                       finishSeason(worker, season, state);
+                   } });
+
+    // Write the seasons still held by the workers' trace blocks
+    for (auto &block : traceBlocks)
+    {
+        seasonTrace->finishBlock(block);
     }
 
-    // Print the final results in a table format
-    printFinalResults(teamWins, playoffRounds, numSeasons);
+    // Merge the per-worker tallies
+    SeasonTally total;
+    for (const auto &tally : tallies)
+    {
+        total.merge(tally);
+    }
+    resultCache->store(key, total);
+    return total;
 }
 
 /**
- * @brief Resets all games in the schedule that are not user set and resets each team.
+ * @brief Opens the trace of a run if a trace file was given.
  *
- * This function iterates through each week's schedule and each game within the week.
- * For each game that is not user set, it resets the game scores, marks it as incomplete,
- * and resets the Elo rating change. Additionally, it resets each team's statistics.
+ * Only the games not complete in the initial state are traced, since the others end the
+ * same in every season. With importance sampling the season weights are traced too.
+ *
+ * @param initialState The season state every season of the run starts from.
+ * @return False if the trace file could not be written.
  */
-void NFLSim::resetSeason()
+bool NFLSim::startTrace(const SeasonState &initialState)
 {
-    for (auto &weeklyGames : NFLSchedule)
+    if (traceFile.empty())
+    {
+        return true;
+    }
+
+    SeasonTraceInfo info;
+    info.columns = traceColumns;
+    if (config.importanceTeam >= 0)
     {
-        for (auto &game : weeklyGames)
+        info.columns |= TRACE_WEIGHTS;
+    }
+    info.seed = config.seed;
+    for (const auto &team : teamsByIndex)
+    {
+        info.teams.push_back(team->getAbbreviation());
+    }
+    for (int gameId = 0; gameId < initialState.numGames; ++gameId)
+    {
+        if (!initialState.gameComplete[gameId])
         {
-            if (!game->isUserSet())
-            {
-                game->resetGame();
-            }
+            info.games.push_back({static_cast<uint16_t>(gameId), initialState.gameHome[gameId], initialState.gameAway[gameId],
+                                  initialState.gameWeek[gameId], 0});
         }
     }
-    for (const auto &teamPair : teamMapByAbbreviation)
+
+    seasonTrace.reset(new SeasonTraceWriter());
+    if (!seasonTrace->open(traceFile, info))
     {
-        teamPair.second->resetTeam();
+        seasonTrace.reset();
+        return false;
     }
+    return true;
+}
 
-    processAllGames();
+/**
+ * @brief Closes the trace of a run, if one is open.
+ * @return False if the trace could not be written completely.
+ */
+bool NFLSim::finishTrace()
+{
+    if (!seasonTrace)
+    {
+        return true;
+    }
+    bool written = seasonTrace->close();
+    seasonTrace.reset();
+    return written;
+}
+
+/**
+ * @brief Hashes everything the results of a run depend on.
+ *
+ * The number of threads and the estimator are left out, since the tally does not
+ * depend on them.
+ *
+ * @param run The settings of the run.
+ * @param initialState The season state every season starts from.
+ * @param firstSeason The index of the first season.
+ * @param numSeasons The number of seasons.
+ * @return The content hash of the run.
+ */
+uint64_t NFLSim::runKey(const RunConfig &run, const SeasonState &initialState, int firstSeason, int numSeasons) const
+{
+    Fingerprint fingerprint;
+    fingerprint.add(leagueFingerprint(initialState));
+    fingerprint.add(modelFingerprint);
+    fingerprint.add(run.seed);
+    fingerprint.add(firstSeason);
+    fingerprint.add(numSeasons);
+    fingerprint.add(run.mathMode);
+    fingerprint.add(run.antithetic);
+    fingerprint.add(run.importanceTeam);
+    fingerprint.add(run.importanceTeam >= 0 ? run.importanceTilt : 0.0);
+    return fingerprint.hash;
+}
+
+/**
+ * @brief Hashes the model version and the tables that the league's odds and scores are drawn from.
+ */
+void NFLSim::buildModelFingerprint()
+{
+    Fingerprint fingerprint;
+    fingerprint.add(MODEL_VERSION);
+    fingerprint.add(static_cast<uint32_t>(sizeof(SeasonTally)));
+    fingerprint.add(travelAdvantage);
+    fingerprint.add(gameRestAdjustment);
+    fingerprint.add(scoreThresholds);
+    fingerprint.add(scoreGuide);
+    fingerprint.add(marginLogarithms);
+    modelFingerprint = fingerprint.hash;
+}
+
+/**
+ * @brief Compares the fast Elo math against the exact Elo math.
+ *
+ * First the fast logistic is checked against the std::exp logistic over the Elo
+ * differences that occur in practice. Then the seasons are simulated once with each
+ * math mode on the same random streams, and every playoff probability is compared
+ * against its Monte Carlo standard error; the fast mode passes if no probability moves
+ * by more than three standard errors.
+ *
+ * @param numSeasons The number of seasons to simulate per math mode.
+ * @return True if the fast mode passes.
+ */
+bool NFLSim::compareMathModes(int numSeasons)
+{
+    // Kernel error over Elo differences of up to +/- 1200 points
+    double maxExactError = 0.0;
+    double maxFastError = 0.0;
+    for (int step = -120000; step <= 120000; ++step)
+    {
+        double eloDifference = step * 0.01;
+        double reference = 1.0 / (1.0 + std::exp(-eloDifference / 400.0));
+        maxExactError = std::max(maxExactError, std::abs(EloMath::logistic(eloDifference, MathMode::Exact) - reference));
+        maxFastError = std::max(maxFastError, std::abs(EloMath::logistic(eloDifference, MathMode::Fast) - reference));
+    }
+
+    std::cout << "Max logistic error vs std::exp: exact " << std::scientific << std::setprecision(2) << maxExactError
+              << ", fast " << maxFastError << " (budget " << EloMath::FAST_LOGISTIC_MAX_ERROR << ")" << std::endl;
+    std::cout << std::defaultfloat;
+
+    // Simulate the same seasons with both math modes
+    const SeasonState initialState = buildSeasonState();
+    RunConfig exactRun = config;
+    exactRun.mathMode = MathMode::Exact;
+    SeasonTally exact = runSeasons(exactRun, initialState, 0, numSeasons, false);
+    RunConfig fastRun = config;
+    fastRun.mathMode = MathMode::Fast;
+    SeasonTally fast = runSeasons(fastRun, initialState, 0, numSeasons, false);
+
+    if (exact.seasons == 0)
+    {
+        return false;
+    }
+
+    // Largest difference of any playoff probability, in percentage points and standard errors
+    double n = static_cast<double>(exact.seasons);
+    double maxDifference = 0.0;
+    double maxSigmas = 0.0;
+    for (const auto &team : teamsByIndex)
+    {
+        int teamIndex = team->getScheduleIndex();
+        for (int round = 1; round < NUM_PLAYOFF_ROUNDS; ++round)
+        {
+            double exactProb = exact.countReached(teamIndex, round) / n;
+            double fastProb = fast.countReached(teamIndex, round) / n;
+            double difference = std::abs(fastProb - exactProb);
+            double standardError = std::sqrt(std::max(exactProb * (1.0 - exactProb), 1.0 / n) / n);
+
+            maxDifference = std::max(maxDifference, difference);
+            maxSigmas = std::max(maxSigmas, difference / standardError);
+        }
+    }
+
+    bool pass = maxSigmas <= 3.0 && maxFastError <= EloMath::FAST_LOGISTIC_MAX_ERROR;
+    std::cout << "Seed: " << config.seed << ", seasons per mode: " << exact.seasons << std::endl;
+    std::cout << "Max playoff probability difference: " << std::fixed << std::setprecision(4) << maxDifference * 100.0
+              << " points (" << std::setprecision(2) << maxSigmas << " standard errors)" << std::endl;
+    std::cout << (pass ? "PASS" : "FAIL") << ": fast math "
+              << (pass ? "stays within" : "exceeds") << " its error budget and Monte Carlo noise" << std::endl;
+    return pass;
+}
+
+/**
+ * @brief Records the wins and playoff round of every team for a simulated season.
+ * @param state The simulated season.
+ * @param tally The tally to record the season into.
+ */
+void NFLSim::recordSeason(const SeasonState &state, SeasonTally &tally) const
+{
+    std::array<int, MAX_TEAMS> teamSeeds{};
+    for (const auto &seeds : state.playoffSeeds)
+    {
+        for (int seedNumber = 0; seedNumber < PLAYOFF_TEAMS; ++seedNumber)
+        {
+            teamSeeds[seeds[seedNumber]] = seedNumber + 1;
+        }
+    }
+
+    for (int team = 0; team < state.numTeams; ++team)
+    {
+        double control = state.teamWins[team] - state.teamExpectedWins[team];
+        tally.addTeamResult(team, state.teamWins[team], state.playoffRound[team], teamSeeds[team], control, state.weight);
+    }
+    tally.addSeason(state.weight);
+}
+
+/**
+ * @brief Copies a season state into the Team and Game objects for printing.
+ * @param state The season state to copy.
+ */
+void NFLSim::applySeasonState(const SeasonState &state)
+{
+    for (int team = 0; team < state.numTeams; ++team)
+    {
+        teamsByIndex[team]->setEloRating(state.teamElo[team]);
+        teamsByIndex[team]->setWinCount(state.teamWins[team]);
+        teamsByIndex[team]->setPlayoffRound(state.playoffRound[team]);
+    }
+    seasonResults = state.headToHead;
+
+    for (int gameId = 0; gameId < state.numGames; ++gameId)
+    {
+        Game &game = *seasonGames[gameId];
+        game.setHomeTeamScore(state.gameHomeScore[gameId]);
+        game.setAwayTeamScore(state.gameAwayScore[gameId]);
+        game.setGameComplete(state.gameComplete[gameId] != 0);
+        game.setHomeTeamOdds(state.gameOdds[gameId]);
+    }
 }
 
 /**
  * @brief Prints the final results of all simulated seasons.
  *
- * This function prints the number of wins for each team in each season, calculates
- * the probabilities of reaching different playoff rounds, and prints the average
- * number of wins for each team across all simulated seasons.
+ * This function calculates the average number of wins and the probabilities of
+ * reaching the different playoff rounds for each team, with the control-variate
+ * estimator if it is enabled, and prints them in a table sorted by team abbreviation.
+ * With intervals shown, a last column holds the widest 95% confidence half-width of
+ * the team's playoff probabilities.
  *
- * @param teamWins A map containing the number of wins for each team across all seasons.
- * @param playoffRounds A map containing the playoff rounds reached by each team across all seasons.
- * @param numSeasons The number of seasons simulated.
+ * @param tally The merged results of all simulated seasons.
+ * @param showIntervals Whether to print the confidence half-width column.
+ * @param out The stream to print to.
  */
-void NFLSim::printFinalResults(const std::map<std::string, std::vector<int>> &teamWins, const std::map<std::string, std::vector<int>> &playoffRounds, int numSeasons) const
+void NFLSim::printFinalResults(const SeasonTally &tally, bool showIntervals, std::ostream &out) const
 {
+    ReportWriter report;
+    Estimator estimator = config.estimator();
+    if (config.antithetic || estimator == Estimator::ControlVariate)
+    {
+        report.write("Variance reduction:");
+        report.write(config.antithetic ? " antithetic pairs" : "");
+        report.write(config.antithetic && estimator == Estimator::ControlVariate ? "," : "");
+        report.write(estimator == Estimator::ControlVariate ? " control variates" : "");
+        report.endLine();
+    }
+    if (estimator == Estimator::Importance)
+    {
+        report.write("Importance sampling: target ");
+        report.write(teamsByIndex[config.importanceTeam]->getName());
+        report.write(", tilt ");
+        report.writeGeneral(config.importanceTilt);
+        report.write(" Elo, effective sample size ");
+        report.writeFixed(tally.effectiveSampleSize(), 0);
+        report.write(" of ");
+        report.writeInt(tally.seasons);
+        report.write(" seasons");
+        report.endLine();
+    }
+
     // Calculate and print playoff probabilities
-    std::cout << std::left << std::setw(15) << "Team" << " | " << "Avg Wins" << " | " << "WildCard" << " | " << "Divisional" << " | " << "Conference" << " | " << "Super Bowl" << " | " << "Championships" << std::endl;
-    std::cout << std::string(95, '-') << std::endl;
+    report.write("Team            | Avg Wins | Win SD | WildCard | Divisional | Conference | Super Bowl | Championships");
+    if (showIntervals)
+    {
+        report.write(" | 95% CI +/-");
+    }
+    report.endLine();
+    report.writeRepeated('-', showIntervals ? 117 : 104);
+    report.endLine();
+
+    if (tally.seasons == 0)
+    {
+        report.flush(out);
+        return;
+    }
+
+    std::map<std::string, int> sortedTeams;
+    for (const auto &teamPair : teamMapByAbbreviation)
+    {
+        sortedTeams[teamPair.first] = teamPair.second->getScheduleIndex();
+    }
+
+    // Each value is left-aligned in a column of the given width
+    auto writeColumn = [&report](double value, int width, int precision)
+    {
+        report.write(" | ");
+        size_t column = report.mark();
+        report.writeFixed(value, precision);
+        report.padFrom(column, width);
+    };
 
-    for (const auto &teamPair : teamWins)
+    for (const auto &teamPair : sortedTeams)
     {
         const std::string &teamName = teamPair.first;
-        const std::vector<int> &wins = teamPair.second;
-        const std::vector<int> &rounds = playoffRounds.at(teamName);
-        double totalWins = std::accumulate(wins.begin(), wins.end(), 0.0);
-        double averageWins = totalWins / static_cast<double>(numSeasons);
-
-        int wildCardCount = 0;
-        int divisionalCount = 0;
-        int conferenceCount = 0;
-        int superBowlCount = 0;
-        int championshipCount = 0;
-
-        for (int round : rounds)
-        {
-            if (round >= 1)
-                wildCardCount++;
-            if (round >= 2)
-                divisionalCount++;
-            if (round >= 3)
-                conferenceCount++;
-            if (round >= 4)
-                superBowlCount++;
-            if (round == 5)
-                championshipCount++;
-        }
-
-        double wildCardProb = static_cast<double>(wildCardCount) / numSeasons * 100.0;
-        double divisionalProb = static_cast<double>(divisionalCount) / numSeasons * 100.0;
-        double conferenceProb = static_cast<double>(conferenceCount) / numSeasons * 100.0;
-        double superBowlProb = static_cast<double>(superBowlCount) / numSeasons * 100.0;
-        double championshipProb = static_cast<double>(championshipCount) / numSeasons * 100.0;
-
-        std::cout << std::left << std::setw(15) << teamName
-                  << " | " << std::setw(8) << std::fixed << std::setprecision(2) << averageWins
-                  << " | " << std::setw(10) << std::fixed << std::setprecision(2) << wildCardProb
-                  << " | " << std::setw(10) << std::fixed << std::setprecision(2) << divisionalProb
-                  << " | " << std::setw(10) << std::fixed << std::setprecision(2) << conferenceProb
-                  << " | " << std::setw(10) << std::fixed << std::setprecision(2) << superBowlProb
-                  << " | " << std::setw(10) << std::fixed << std::setprecision(2) << championshipProb << std::endl;
+        int teamIndex = teamPair.second;
+
+        size_t column = report.mark();
+        report.write(teamName);
+        report.padFrom(column, 15);
+        writeColumn(tally.averageWins(teamIndex, estimator), 8, 2);
+        writeColumn(tally.winStandardDeviation(teamIndex, estimator), 6, 2);
+        for (int round = 1; round < NUM_PLAYOFF_ROUNDS; ++round)
+        {
+            writeColumn(tally.probability(teamIndex, round, estimator) * 100.0, 10, 2);
+        }
+
+        if (showIntervals)
+        {
+            double widest = 0.0;
+            for (int round = 1; round < NUM_PLAYOFF_ROUNDS; ++round)
+            {
+                widest = std::max(widest, tally.halfWidth(teamIndex, round, estimator));
+            }
+            report.write("   ");
+            writeColumn(widest * 100.0, 10, 3);
+        }
+        report.endLine();
+    }
+    report.flush(out);
+}
+
+/**
+ * @brief Prints and exports the win total and seed distributions if requested.
+ * @param tally The results of the run.
+ * @param out The stream to print to.
+ */
+void NFLSim::reportDistributions(const SeasonTally &tally, std::ostream &out) const
+{
+    if (showDistributions)
+    {
+        printDistributions(tally, out);
+    }
+    if (!distributionsFile.empty())
+    {
+        exportDistributions(tally, distributionsFile);
+    }
+}
+
+/**
+ * @brief Prints each team's playoff seed and win total distributions.
+ *
+ * Win totals are shown per whole win; a season ending on a half win from a tie is
+ * counted with the whole win below it. The exported CSV keeps the half wins apart.
+ *
+ * @param tally The results to print.
+ * @param out The stream to print to.
+ */
+void NFLSim::printDistributions(const SeasonTally &tally, std::ostream &out) const
+{
+    if (tally.seasons == 0)
+    {
+        return;
+    }
+
+    Estimator estimator = config.estimator();
+    std::map<std::string, int> sortedTeams;
+    for (const auto &teamPair : teamMapByAbbreviation)
+    {
+        sortedTeams[teamPair.first] = teamPair.second->getScheduleIndex();
+    }
+
+    out << std::endl << "Playoff seed probabilities (%)" << std::endl;
+    out << std::left << std::setw(15) << "Team" << " |";
+    for (int seedNumber = 1; seedNumber <= PLAYOFF_TEAMS; ++seedNumber)
+    {
+        out << std::right << std::setw(7) << seedNumber;
+    }
+    out << std::right << std::setw(7) << "Out" << std::endl;
+    out << std::string(17 + 7 * (PLAYOFF_TEAMS + 1), '-') << std::endl;
+
+    for (const auto &teamPair : sortedTeams)
+    {
+        out << std::left << std::setw(15) << teamPair.first << " |" << std::right << std::fixed << std::setprecision(2);
+        for (int seedNumber = 1; seedNumber <= PLAYOFF_TEAMS; ++seedNumber)
+        {
+            out << std::setw(7) << tally.seedProbability(teamPair.second, seedNumber, estimator) * 100.0;
+        }
+        out << std::setw(7) << tally.seedProbability(teamPair.second, 0, estimator) * 100.0 << std::endl;
+    }
+
+    out << std::endl << "Win total probabilities (%)" << std::endl;
+    out << std::left << std::setw(15) << "Team" << " |";
+    for (int wins = 0; wins <= MAX_REGULAR_SEASON_WINS; ++wins)
+    {
+        out << std::right << std::setw(6) << wins;
+    }
+    out << std::endl;
+    out << std::string(17 + 6 * (MAX_REGULAR_SEASON_WINS + 1), '-') << std::endl;
+
+    for (const auto &teamPair : sortedTeams)
+    {
+        out << std::left << std::setw(15) << teamPair.first << " |" << std::right << std::fixed << std::setprecision(1);
+        for (int wins = 0; wins <= MAX_REGULAR_SEASON_WINS; ++wins)
+        {
+            double probability = tally.winTotalProbability(teamPair.second, 2 * wins, estimator);
+            if (2 * wins + 1 < NUM_WIN_BINS)
+            {
+                probability += tally.winTotalProbability(teamPair.second, 2 * wins + 1, estimator);
+            }
+            out << std::setw(6) << probability * 100.0;
+        }
+        out << std::endl;
+    }
+    out << std::left;
+}
+
+/**
+ * @brief Writes each team's playoff seed and win total distributions to a CSV file.
+ *
+ * Every row holds one team, measure ("wins" or "seed"), value and probability. Win totals
+ * go from 0 to 17 in half wins and seeds from 1 to 7, with 0 for missing the playoffs.
+ *
+ * @param tally The results to export.
+ * @param filename The CSV file to write.
+ */
+void NFLSim::exportDistributions(const SeasonTally &tally, const std::string &filename) const
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open file " << filename << " for writing." << std::endl;
+        return;
+    }
+
+    Estimator estimator = config.estimator();
+    std::map<std::string, int> sortedTeams;
+    for (const auto &teamPair : teamMapByAbbreviation)
+    {
+        sortedTeams[teamPair.first] = teamPair.second->getScheduleIndex();
     }
+
+    file << "team,measure,value,probability\n" << std::fixed;
+    for (const auto &teamPair : sortedTeams)
+    {
+        for (int halfWins = 0; halfWins < NUM_WIN_BINS; ++halfWins)
+        {
+            file << teamPair.first << ",wins," << std::setprecision(1) << halfWins * 0.5 << ","
+                 << std::setprecision(8) << tally.winTotalProbability(teamPair.second, halfWins, estimator) << "\n";
+        }
+        for (int seedNumber = 0; seedNumber <= PLAYOFF_TEAMS; ++seedNumber)
+        {
+            file << teamPair.first << ",seed," << seedNumber << ","
+                 << std::setprecision(8) << tally.seedProbability(teamPair.second, seedNumber, estimator) << "\n";
+        }
+    }
+
+    std::cout << "Distributions saved to " << filename << std::endl;
 }
@@ -2,76 +2,285 @@
 #define NFLSIM_H
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>
-#include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
 #include <numeric>
-#include <random>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "Game.h"
+#include "CsvReader.h"
+#include "EloMath.h"
+#include "Fingerprint.h"
+#include "LeagueImage.h"
+#include "MonteCarloEngine.h"
+#include "ReportWriter.h"
+#include "ResultCache.h"
+#include "RunCheckpoint.h"
+#include "SeasonBatch.h"
+#include "SeasonRng.h"
+#include "SeasonSnapshot.h"
+#include "SeasonState.h"
+#include "SeasonTally.h"
+#include "SeasonTrace.h"
+
+// Version of the simulation logic, hashed into the model fingerprint so cached results
+// and checkpoints of an older build are never mixed with new ones. Bump it whenever the
+// kernels, the playoff seeding or the tiebreakers change the results of a seed.
+constexpr uint32_t MODEL_VERSION = 1;
+
+// Options of a simulation run given on the command line
+struct SimulationOptions
+{
+    uint64_t seed = 0;                   // Seed of the random streams of all simulated seasons
+    MathMode mathMode = MathMode::Exact; // Exact or fast Elo math
+    bool compareMath = false;            // Compare fast against exact Elo math instead of a plain run
+    bool antithetic = false;             // Simulate seasons in antithetic pairs
+    bool controlVariates = false;        // Correct the estimates with the expected-wins control variate
+    std::string importanceTarget;        // Abbreviation of the team importance sampling favours, empty for none
+    double importanceTilt = 100.0;       // Elo points added in the target team's favour when sampling
+    std::string checkpointFile;          // File the progress of long runs is saved to, empty for none
+    int checkpointInterval = 1000000;    // Seasons simulated between checkpoints
+    std::string resumeFile;              // Checkpoint to resume instead of starting a new run, empty for none
+    bool showDistributions = false;      // Print the win total and seed distributions with the results
+    std::string distributionsFile;       // CSV file the distributions are exported to, empty for none
+    std::string teamsFile = "static/preseason_nfl_teams.csv"; // CSV file of the teams and their preseason Elo
+    int numThreads = 0;                  // Worker threads, 0 for one per hardware thread
+    int batchSeasons = 0;                // Seasons to simulate without prompts, 0 for the interactive mode
+    std::string outputFile;              // File the results are written to instead of the terminal, empty for none
+    int cacheEntries = 64;               // Simulated results kept in memory for identical runs
+    std::string cacheDirectory;          // Directory results are also cached in across processes, empty for none
+    std::string compileFile;             // File the loaded league is compiled into instead of simulating, empty for none
+    bool compactSchedule = false;        // Print schedules as one line per team instead of one line per game
+    std::string traceFile;               // File every simulated season is traced to, empty for none
+    uint32_t traceColumns = TRACE_DEFAULT_COLUMNS; // Columns of the trace
+};
+
+// Settings of one simulation run. The league itself only holds what every run shares,
+// so runs with different settings can simulate the same league at the same time.
+struct RunConfig
+{
+    int numThreads = 1;                  // Worker threads
+    uint64_t seed = 0;                   // Seed of the random streams of all simulated seasons
+    MathMode mathMode = MathMode::Exact; // Exact or fast Elo math
+    bool antithetic = false;             // Whether seasons are simulated in antithetic pairs
+    bool controlVariates = false;        // Whether the results use the control-variate estimator
+    int importanceTeam = -1;             // Schedule index of the importance sampling target, -1 for none
+    double importanceTilt = 100.0;       // Elo points added in the target team's favour when sampling
+    double importanceFactor = std::exp(-100.0 / 400.0); // e^(-importanceTilt / 400), the odds ratio of the tilt
+
+    /**
+     * @brief Sets the importance sampling tilt and its odds ratio.
+     * @param tilt The Elo points added in the target team's favour.
+     */
+    void setImportanceTilt(double tilt)
+    {
+        importanceTilt = tilt;
+        importanceFactor = std::exp(-tilt / 400.0);
+    }
+
+    /**
+     * @brief Chooses the estimator of the results from the sampling options.
+     * @return Importance weighting with a target team, else the control variate if enabled.
+     */
+    Estimator estimator() const
+    {
+        if (importanceTeam >= 0)
+        {
+            return Estimator::Importance;
+        }
+        return controlVariates ? Estimator::ControlVariate : Estimator::Plain;
+    }
+};
+
+// Teams taking part in a tiebreaker, by schedule index
+struct TeamGroup
+{
+    std::array<int, MAX_TEAMS> teams;
+    int size = 0;
+
+    /**
+     * @brief Adds a team to the group.
+     * @param team The schedule index of the team.
+     */
+    void add(int team)
+    {
+        teams[size++] = team;
+    }
+
+    /**
+     * @brief Removes a team from the group, keeping the order of the others.
+     * @param team The schedule index of the team.
+     */
+    void remove(int team)
+    {
+        size = static_cast<int>(std::remove(teams.begin(), teams.begin() + size, team) - teams.begin());
+    }
+};
+
+// Steps of the NFL tiebreaker procedures, compared by winning percentage
+enum class TiebreakStep
+{
+    HeadToHead,        // Games between the tied teams
+    DivisionRecord,    // Games against division rivals
+    CommonGames,       // Games against opponents all tied teams played
+    ConferenceRecord,  // Games against conference opponents
+    StrengthOfVictory, // Combined record of the opponents beaten
+    StrengthOfSchedule // Combined record of all opponents
+};
 
 class NFLSim
 {
 public:
     // Constructor and Destructor
-    NFLSim(const std::string &filename);
+    NFLSim(const std::string &filename, const SimulationOptions &options);
     ~NFLSim();
 
+    bool hasFailed() const;
+
 private:
+    friend class NFLSimulator;
+
+    // Loads the league and, if requested, runs the simulation
+    NFLSim(const std::string &scheduleFilename, const SimulationOptions &options, bool run);
+
+    // Deep copy of the league, used as a scratch view for printing simulated seasons
+    NFLSim(const NFLSim &other);
+
     // Core Simulation Functions
     void runSimulation();
     void handleRunCommand(bool print);
-    void simulateRegularSeason();
-    void simulatePlayoffs();
+    void simulateRegularSeason(const RunConfig &run, SeasonState &state, SeasonRng &rng) const;
+    void simulateRegularSeasonBatch(const RunConfig &run, SeasonBatch &batch, const SeasonState &initialState, SeasonRngLanes &rng) const;
+    void simulatePlayoffs(const RunConfig &run, SeasonState &state, SeasonRng &rng) const;
     void simulateMultipleSeasons(int numSeasons, bool print);
+    void resumeRun();
+    void continueRun(RunCheckpoint &checkpoint, bool print);
+    uint64_t leagueFingerprint(const SeasonState &state) const;
+    uint64_t runKey(const RunConfig &run, const SeasonState &initialState, int firstSeason, int numSeasons) const;
+    void buildModelFingerprint();
+    SeasonTally runSeasons(const SeasonState &initialState, int firstSeason, int numSeasons, bool print) const;
+    SeasonTally runSeasons(const RunConfig &run, const SeasonState &initialState, int firstSeason, int numSeasons, bool print) const;
+    bool startTrace(const SeasonState &initialState);
+    bool finishTrace();
+    void simulateUntilConfident(double targetHalfWidth);
+    bool compareMathModes(int numSeasons);
+    void recordSeason(const SeasonState &state, SeasonTally &tally) const;
     void saveScheduelAsCSV(const std::string &filename) const;
 
     // Schedule and Team Management
-    void readSchedule(const std::string &filename);
-    void readTeams(const std::string &filename);
+    bool readSchedule(const std::string &filename);
+    bool readTeams(const std::string &filename);
+    std::shared_ptr<Team> findTeam(std::string_view abbreviation) const;
+    bool readLeagueImage(const std::string &filename);
+    bool compileLeague(const std::string &filename) const;
     void processAllGames();
-    void processTeamGames(int teamIndex);
-    std::vector<std::string> parseGameInfo(const std::string &teamName, const std::string &gameInfo, int week);
-    void resetSeason();
+    void markTeamOddsDirty(int teamIndex);
+    void refreshOdds();
+
+    // Season State Management
+    void buildGameIndex();
+    void buildSeasonLayout();
+    void buildSeasonResults();
+    void fillGameLayout(SeasonState &state) const;
+    SeasonState buildSeasonState() const;
+    SeasonState buildSeasonState(const SeasonSnapshot &snapshot) const;
+    void applySeasonState(const SeasonState &state);
+
+    // What-If Snapshots
+    SeasonSnapshot takeSnapshot() const;
+    void replaySnapshot(SeasonSnapshot &snapshot, int fromWeek) const;
+    bool setSnapshotResult(SeasonSnapshot &snapshot, int teamIndex, int week, int homeScore, int awayScore) const;
+    void evaluateWhatIfs();
 
     // Playoff Management
-    void determinePlayoffTeams();
-    void determineDivisionWinners();
-    void determineWildCardTeams();
-    std::shared_ptr<Team> resolveTiebreaker(const std::shared_ptr<Team> &team1, const std::shared_ptr<Team> &team2);
-    std::shared_ptr<Team> simulatePlayoffGame(std::shared_ptr<Team> homeTeam, std::shared_ptr<Team> awayTeam);
+    void determinePlayoffTeams(SeasonState &state, SeasonRng &rng) const;
+    int determineDivisionWinners(SeasonState &state, SeasonRng &rng, int conference) const;
+    void determineWildCardTeams(SeasonState &state, SeasonRng &rng, int conference, int numSeeded) const;
+    int pickBestTeam(const SeasonState &state, SeasonRng &rng, const TeamGroup &candidates, bool withinDivision) const;
+    int breakTie(const SeasonState &state, SeasonRng &rng, TeamGroup tied, bool wildCard) const;
+    bool applyTiebreakStep(const SeasonState &state, TeamGroup &tied, TiebreakStep step, bool wildCard) const;
+    int simulatePlayoffGame(const RunConfig &run, SeasonState &state, SeasonRng &rng, int homeIndex, int awayIndex) const;
 
     // Elo Rating and Game Processing
     void manualGameResults();
     void updateEloRatings(std::shared_ptr<Game> gamePtr);
+    void updateEloRatings(SeasonState &state, int homeIndex, int awayIndex, int homeScore, int awayScore, MathMode mode) const;
+    double calculateEloChange(double homeElo, double awayElo, int homeScore, int awayScore, MathMode mode) const;
     void calculateHomeOdds(std::shared_ptr<Game> &game);
-    double calculateFieldAdvantage(const City &homeCity, const City &awayCity);
-    double adjustEloForByes(const Game &game, const Team &homeTeam, const Team &awayTeam);
-    double calculateHomeOddsFromEloDiff(double eloDiff);
+    double calculateHomeOdds(const SeasonState &state, int gameId, MathMode mode) const;
+    double calculateFieldAdvantage(const City &homeCity, const City &awayCity) const;
+    void buildAdjustmentTables();
+    void buildScoreTable();
+    int scoreFromUniform(double randomValue) const;
+    int drawRegularSeasonScore(SeasonRng &rng) const;
+    LaneDouble drawRegularSeasonScores(SeasonRngLanes &rng) const;
+    double marginLogarithm(int pointDifference) const;
+    double calculateHomeOddsFromEloDiff(double eloDiff, MathMode mode) const;
+    double tiltHomeOdds(const RunConfig &run, double homeOdds, int homeIndex, int awayIndex) const;
 
     // Output Functions
-    void printSchedule() const;
-    void printTeamHeader(const std::shared_ptr<Team> &team, int teamColumnWidth, int weekColumnWidth, int gameColumnWidth) const;
-    void printTeamGames(const std::shared_ptr<Team> &team, const std::vector<std::shared_ptr<Game>> &games, int teamColumnWidth, int gameColumnWidth) const;
-    void printSeasonResults(const std::map<std::string, std::vector<int>> &teamWins, int season) const;
-    void printFinalResults(const std::map<std::string, std::vector<int>> &teamWins, const std::map<std::string, std::vector<int>> &playoffRounds, int numSeasons) const;
+    void printSchedule();
+    void printTeamHeader(ReportWriter &report, const Team &team, int teamColumnWidth, int weekColumnWidth, int gameColumnWidth) const;
+    void printTeamGames(ReportWriter &report, const Team &team, const std::vector<std::shared_ptr<Game>> &games, int teamColumnWidth, int gameColumnWidth) const;
+    void printCompactSchedule(ReportWriter &report) const;
+    void printFinalResults(const SeasonTally &tally, bool showIntervals, std::ostream &out) const;
+    void reportDistributions(const SeasonTally &tally, std::ostream &out) const;
+    void printDistributions(const SeasonTally &tally, std::ostream &out) const;
+    void exportDistributions(const SeasonTally &tally, const std::string &filename) const;
 
     // Data Members
     std::vector<std::vector<std::shared_ptr<Game>>> NFLSchedule;
     std::unordered_map<std::string, std::shared_ptr<Team>> teamMapByAbbreviation;
     std::map<std::string, std::map<std::string, std::vector<std::shared_ptr<Team>>>> leagueStructure;
-    std::map<std::string, std::vector<std::shared_ptr<Team>>> playoffSeeding;
+
+    // Flat game index used by season states
+    std::vector<std::shared_ptr<Game>> seasonGames;           // Game object of each game id, ordered by week
+    std::vector<int> weekGameOffsets;                         // First game id of each week, plus the end
+    std::vector<std::vector<int>> teamGameIds;                // Game id per team and week, -1 for byes
+    std::vector<std::shared_ptr<Team>> teamsByIndex;          // Team object of each schedule index
+    std::array<double, MAX_TEAMS> preseasonElo{};             // Elo rating per schedule index before any result
+    std::vector<std::vector<std::vector<int>>> conferenceDivisions; // Team indices per conference and division
+    std::array<int, MAX_TEAMS> teamDivision{};                // Division number per schedule index, unique across conferences
+    std::array<uint32_t, MAX_TEAMS> divisionRivals{};         // Bit per other team of the same division
+    std::array<uint32_t, MAX_TEAMS> conferenceRivals{};       // Bit per other team of the same conference
+    HeadToHeadMatrix seasonResults;                           // Head-to-head results of the completed games
+
+    // Static odds adjustments, computed once after loading
+    std::array<std::array<double, MAX_TEAMS>, MAX_TEAMS> travelAdvantage{}; // Home field and travel Elo points per home/away pair
+    std::vector<double> gameRestAdjustment;                                 // Bye week Elo points per game id
+    std::array<double, NUM_SCORE_THRESHOLDS> scoreThresholds{};             // Probability of a regular season score below 1, 2, ...
+    std::array<uint8_t, SCORE_GUIDE_SLICES> scoreGuide{};                   // Regular season score at the start of each slice of [0, 1)
+    std::array<double, NUM_MARGIN_LOGARITHMS> marginLogarithms{};           // ln(d + 1) per point difference d
+    RunConfig config;  // Settings of the runs started from the command line
+    bool compareMath;  // Whether the run command compares the math modes
+    std::string checkpointFile; // File the progress of long runs is saved to, empty for none
+    int checkpointInterval;     // Seasons simulated between checkpoints
+    std::string resumeFile;     // Checkpoint to resume instead of starting a new run, empty for none
+    bool showDistributions;        // Whether to print the win total and seed distributions
+    bool compactSchedule;          // Whether schedules are printed as one line per team
+    ReportWriter scheduleReport;   // Buffer printed schedules are rendered into, reused across seasons
+    std::string distributionsFile; // CSV file the distributions are exported to, empty for none
+    std::string outputFile;        // File the results are written to instead of the terminal, empty for none
+    bool failed;                   // Whether loading the league or a headless run failed
+    uint64_t modelFingerprint;                 // Hash of the odds adjustments and the score distribution
+    std::shared_ptr<ResultCache> resultCache; // Results of earlier identical runs, shared with copies
+    std::string traceFile;                      // File the seasons of a run are traced to, empty for none
+    uint32_t traceColumns;                      // Columns of the trace
+    std::unique_ptr<SeasonTraceWriter> seasonTrace; // Trace of the run in progress, nullptr when not tracing
 };
 
 #endif // NFLSIM_H
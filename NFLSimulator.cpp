@@ -0,0 +1,171 @@
+#include "NFLSimulator.h"
+
+#include "NFLSim.h"
+
+static_assert(NUM_PLAYOFF_ROUNDS == std::tuple_size<decltype(TeamForecast::roundProbabilities)>::value + 1,
+              "TeamForecast has one probability per playoff round after missing the playoffs");
+static_assert(PLAYOFF_TEAMS + 1 == std::tuple_size<decltype(TeamForecast::seedProbabilities)>::value,
+              "TeamForecast has one probability per seed plus missing the playoffs");
+static_assert(NUM_WIN_BINS == std::tuple_size<decltype(TeamForecast::winTotalProbabilities)>::value,
+              "TeamForecast has one probability per win total bin");
+
+NFLSimulator::NFLSimulator() {}
+
+NFLSimulator::~NFLSimulator() {}
+
+/**
+ * @brief Loads a league for forecasting.
+ * @param scheduleFile The schedule CSV file, or a league image compiled with --compile.
+ * @param teamsFile The CSV file of the teams and their preseason Elo ratings, unused for an image.
+ * @param cacheDirectory The directory forecasts are also cached in, empty for memory only.
+ * @param cacheEntries The number of forecasts kept in memory.
+ * @return The simulator, or nullptr if the files could not be loaded.
+ */
+std::unique_ptr<NFLSimulator> NFLSimulator::load(const std::string &scheduleFile, const std::string &teamsFile,
+                                                 const std::string &cacheDirectory, int cacheEntries)
+{
+    SimulationOptions options;
+    options.teamsFile = teamsFile;
+    options.cacheDirectory = cacheDirectory;
+    options.cacheEntries = cacheEntries;
+
+    std::unique_ptr<NFLSimulator> simulator(new NFLSimulator());
+    simulator->league.reset(new NFLSim(scheduleFile, options, false));
+    if (simulator->league->hasFailed())
+    {
+        return nullptr;
+    }
+
+    simulator->loaded.reset(new SeasonSnapshot(simulator->league->takeSnapshot()));
+    simulator->results.reset(new SeasonSnapshot(simulator->loaded->fork()));
+    return simulator;
+}
+
+/**
+ * @brief Gets the abbreviations of the teams in the league.
+ * @return The abbreviations, in alphabetical order.
+ */
+std::vector<std::string> NFLSimulator::getTeams() const
+{
+    std::vector<std::string> teams;
+    for (const auto &teamPair : league->teamMapByAbbreviation)
+    {
+        teams.push_back(teamPair.first);
+    }
+    std::sort(teams.begin(), teams.end());
+    return teams;
+}
+
+/**
+ * @brief Sets the result of a game for the following forecasts.
+ * @param team The abbreviation of either team.
+ * @param week The week of the game (0-based).
+ * @param homeScore The score of the home team.
+ * @param awayScore The score of the away team; 0-0 clears the result.
+ * @return False if the team is unknown or has no game that week.
+ */
+bool NFLSimulator::setResult(const std::string &team, int week, int homeScore, int awayScore)
+{
+    auto teamIt = league->teamMapByAbbreviation.find(team);
+    if (teamIt == league->teamMapByAbbreviation.end())
+    {
+        std::cerr << "Error: Unknown team: " << team << std::endl;
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(resultsMutex);
+    if (!league->setSnapshotResult(*results, teamIt->second->getScheduleIndex(), week, homeScore, awayScore))
+    {
+        std::cerr << "Error: " << team << " has no game in week " << week << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Restores the results loaded from the schedule.
+ */
+void NFLSimulator::resetResults()
+{
+    std::unique_lock<std::shared_mutex> lock(resultsMutex);
+    *results = loaded->fork();
+}
+
+/**
+ * @brief Simulates seasons from the current results and collects the forecast.
+ * @param options The options of the forecast.
+ * @param forecast Set to the results.
+ * @return False if the options are invalid.
+ */
+bool NFLSimulator::run(const ForecastOptions &options, Forecast &forecast) const
+{
+    if (options.seasons <= 0)
+    {
+        std::cerr << "Error: The number of seasons must be a positive number." << std::endl;
+        return false;
+    }
+    if (options.controlVariates && !options.target.empty())
+    {
+        std::cerr << "Error: Control variates cannot be combined with importance sampling" << std::endl;
+        return false;
+    }
+
+    // Settings of this forecast only; the league is shared by every forecast
+    RunConfig config;
+    config.numThreads = options.threads > 0 ? options.threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    config.seed = options.seed;
+    config.mathMode = options.fastMath ? MathMode::Fast : MathMode::Exact;
+    config.antithetic = options.antithetic;
+    config.controlVariates = options.controlVariates;
+    if (!options.target.empty())
+    {
+        auto target = league->teamMapByAbbreviation.find(options.target);
+        if (target == league->teamMapByAbbreviation.end())
+        {
+            std::cerr << "Error: Unknown importance sampling target: " << options.target << std::endl;
+            return false;
+        }
+        config.importanceTeam = target->second->getScheduleIndex();
+        config.setImportanceTilt(options.tilt);
+    }
+
+    // Forking only copies a pointer per week, so result changes wait for nothing but the fork
+    SeasonSnapshot start;
+    {
+        std::shared_lock<std::shared_mutex> lock(resultsMutex);
+        start = results->fork();
+    }
+
+    SeasonTally tally = league->runSeasons(config, league->buildSeasonState(start), 0, options.seasons, false);
+    Estimator estimator = config.estimator();
+
+    forecast.seed = options.seed;
+    forecast.seasons = tally.seasons;
+    forecast.effectiveSampleSize = estimator == Estimator::Importance ? tally.effectiveSampleSize() : static_cast<double>(tally.seasons);
+    forecast.teams.clear();
+    for (const auto &abbreviation : getTeams())
+    {
+        const auto &team = league->teamMapByAbbreviation.at(abbreviation);
+        int teamIndex = team->getScheduleIndex();
+
+        TeamForecast teamForecast;
+        teamForecast.abbreviation = abbreviation;
+        teamForecast.name = team->getName();
+        teamForecast.averageWins = tally.averageWins(teamIndex, estimator);
+        teamForecast.winStandardDeviation = tally.winStandardDeviation(teamIndex, estimator);
+        for (int round = 1; round < NUM_PLAYOFF_ROUNDS; ++round)
+        {
+            teamForecast.roundProbabilities[round - 1] = tally.probability(teamIndex, round, estimator);
+        }
+        for (int seed = 0; seed <= PLAYOFF_TEAMS; ++seed)
+        {
+            teamForecast.seedProbabilities[seed] = tally.seedProbability(teamIndex, seed, estimator);
+        }
+        for (int halfWins = 0; halfWins < NUM_WIN_BINS; ++halfWins)
+        {
+            teamForecast.winTotalProbabilities[halfWins] = tally.winTotalProbability(teamIndex, halfWins, estimator);
+        }
+        forecast.teams.push_back(teamForecast);
+    }
+    return true;
+}
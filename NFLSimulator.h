@@ -0,0 +1,77 @@
+#ifndef NFLSIMULATOR_H
+#define NFLSIMULATOR_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+class NFLSim;
+struct SeasonSnapshot;
+
+// Options of one forecast
+struct ForecastOptions
+{
+    int seasons = 10000;          // Seasons to simulate
+    uint64_t seed = 0;            // Seed of the random streams; the same seed gives the same forecast
+    int threads = 0;              // Worker threads, 0 for one per hardware thread
+    bool fastMath = false;        // Use the fast Elo math
+    bool antithetic = false;      // Simulate seasons in antithetic pairs
+    bool controlVariates = false; // Correct the estimates with the expected-wins control variate
+    std::string target;           // Abbreviation of the team importance sampling favours, empty for none
+    double tilt = 100.0;          // Elo points added in the target team's favour when sampling
+};
+
+// Forecast of one team
+struct TeamForecast
+{
+    std::string abbreviation;
+    std::string name;
+    double averageWins = 0.0;
+    double winStandardDeviation = 0.0;
+    std::array<double, 5> roundProbabilities{};     // Reaching the wildcard, divisional, conference round, Super Bowl, and winning it
+    std::array<double, 8> seedProbabilities{};      // Per playoff seed 1-7, index 0 for missing the playoffs
+    std::array<double, 35> winTotalProbabilities{}; // Per win total from 0 to 17 in half wins
+};
+
+// Results of a forecast, with the teams ordered by abbreviation
+struct Forecast
+{
+    uint64_t seed = 0;
+    long long seasons = 0;
+    double effectiveSampleSize = 0.0; // Equals seasons unless importance sampling is on
+    std::vector<TeamForecast> teams;
+};
+
+// Embeddable simulator that loads a league once and answers any number of forecasts.
+// Results set with setResult apply to every later forecast without touching the
+// files the league was loaded from. Identical forecasts are answered from a cache of
+// recent results, optionally backed by a directory. All methods may be called from
+// several threads at once; a forecast starts from a fork of the results set before it,
+// so changing the results never waits for a running forecast.
+class NFLSimulator
+{
+public:
+    static std::unique_ptr<NFLSimulator> load(const std::string &scheduleFile,
+                                              const std::string &teamsFile = "static/preseason_nfl_teams.csv",
+                                              const std::string &cacheDirectory = "",
+                                              int cacheEntries = 64);
+    ~NFLSimulator();
+
+    std::vector<std::string> getTeams() const;
+    bool setResult(const std::string &team, int week, int homeScore, int awayScore);
+    void resetResults();
+    bool run(const ForecastOptions &options, Forecast &forecast) const;
+
+private:
+    NFLSimulator();
+
+    std::unique_ptr<NFLSim> league;          // The loaded league and its precomputed tables
+    std::unique_ptr<SeasonSnapshot> loaded;  // Results as loaded from the schedule
+    std::unique_ptr<SeasonSnapshot> results; // Results the forecasts start from
+    mutable std::shared_mutex resultsMutex;  // Shared while a forecast forks the results, exclusive for changes
+};
+
+#endif // NFLSIMULATOR_H
@@ -0,0 +1,101 @@
+#include "ReportWriter.h"
+
+#include <charconv>
+
+/**
+ * @brief Appends text.
+ * @param text The text.
+ */
+void ReportWriter::write(std::string_view text)
+{
+    buffer.append(text.data(), text.size());
+}
+
+/**
+ * @brief Appends a character several times, e.g. for a table rule.
+ * @param character The character.
+ * @param count The number of times.
+ */
+void ReportWriter::writeRepeated(char character, int count)
+{
+    if (count > 0)
+    {
+        buffer.append(static_cast<size_t>(count), character);
+    }
+}
+
+/**
+ * @brief Appends an integer.
+ * @param value The integer.
+ */
+void ReportWriter::writeInt(long long value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+/**
+ * @brief Appends a number with a fixed number of decimals, like std::fixed.
+ * @param value The number.
+ * @param precision The number of decimals.
+ */
+void ReportWriter::writeFixed(double value, int precision)
+{
+    char digits[352]; // Room for the largest double in fixed notation
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+    buffer.append(digits, result.ptr);
+}
+
+/**
+ * @brief Appends a number with six significant digits, like a stream's default format.
+ * @param value The number.
+ */
+void ReportWriter::writeGeneral(double value)
+{
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+    buffer.append(digits, result.ptr);
+}
+
+/**
+ * @brief Ends the current line.
+ */
+void ReportWriter::endLine()
+{
+    buffer.push_back('\n');
+}
+
+/**
+ * @brief Marks the start of a column, to be padded with padFrom.
+ * @return The current end of the report.
+ */
+size_t ReportWriter::mark() const
+{
+    return buffer.size();
+}
+
+/**
+ * @brief Pads everything written since a mark with spaces to a column width.
+ * @param start The mark at the start of the column.
+ * @param width The width of the column.
+ */
+void ReportWriter::padFrom(size_t start, int width)
+{
+    size_t written = buffer.size() - start;
+    if (written < static_cast<size_t>(width))
+    {
+        buffer.append(static_cast<size_t>(width) - written, ' ');
+    }
+}
+
+/**
+ * @brief Writes the report to a stream in one call and empties the buffer, keeping its capacity.
+ * @param out The stream.
+ */
+void ReportWriter::flush(std::ostream &out)
+{
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    out.flush();
+    buffer.clear();
+}
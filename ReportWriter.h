@@ -0,0 +1,32 @@
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Text report rendered into one reusable buffer and written out in a single call.
+// Numbers are formatted with std::to_chars, so once the buffer has grown to the size
+// of a report, rendering the next one allocates nothing. Columns are left-aligned
+// like the std::left/std::setw tables they replace.
+class ReportWriter
+{
+public:
+    void write(std::string_view text);
+    void writeRepeated(char character, int count);
+    void writeInt(long long value);
+    void writeFixed(double value, int precision);
+    void writeGeneral(double value);
+    void endLine();
+
+    size_t mark() const;
+    void padFrom(size_t start, int width);
+
+    void flush(std::ostream &out);
+
+private:
+    std::string buffer; // Rendered text not yet flushed
+};
+
+#endif // REPORTWRITER_H
@@ -0,0 +1,132 @@
+#include "ResultCache.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <sys/stat.h>
+
+#include "RunCheckpoint.h"
+
+/**
+ * @brief Constructs a cache, creating the directory of the disk tier if needed.
+ * @param entryCapacity The number of results kept in memory, 0 to keep none.
+ * @param cacheDirectory The directory of the disk tier, empty for memory only.
+ */
+ResultCache::ResultCache(size_t entryCapacity, const std::string &cacheDirectory)
+    : capacity(entryCapacity), directory(cacheDirectory)
+{
+    if (!directory.empty())
+    {
+        mkdir(directory.c_str(), 0755);
+    }
+}
+
+/**
+ * @brief Looks up the results for a key, in memory first and then on disk.
+ * @param key The content hash of the run.
+ * @param tally Set to the cached results on a hit.
+ * @return True on a hit.
+ */
+bool ResultCache::lookup(uint64_t key, SeasonTally &tally)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entry = entryIndex.find(key);
+        if (entry != entryIndex.end())
+        {
+            entries.splice(entries.begin(), entries, entry->second);
+            tally = entry->second->second;
+            return true;
+        }
+    }
+
+    if (directory.empty())
+    {
+        return false;
+    }
+
+    // Disk entries are checkpoints of finished runs, keyed by the same hash
+    std::string filename = entryFilename(key);
+    if (!std::ifstream(filename).good())
+    {
+        return false;
+    }
+
+    RunCheckpoint checkpoint;
+    if (!checkpoint.load(filename) || checkpoint.leagueFingerprint != key ||
+        checkpoint.completedSeasons != checkpoint.targetSeasons)
+    {
+        return false;
+    }
+
+    tally = checkpoint.tally;
+    std::lock_guard<std::mutex> lock(mutex);
+    insert(key, tally);
+    return true;
+}
+
+/**
+ * @brief Stores the results for a key in memory and, with a directory, on disk.
+ * @param key The content hash of the run.
+ * @param tally The results.
+ */
+void ResultCache::store(uint64_t key, const SeasonTally &tally)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        insert(key, tally);
+    }
+
+    if (!directory.empty())
+    {
+        RunCheckpoint checkpoint;
+        checkpoint.leagueFingerprint = key;
+        checkpoint.targetSeasons = tally.seasons;
+        checkpoint.completedSeasons = tally.seasons;
+        checkpoint.tally = tally;
+        checkpoint.save(entryFilename(key));
+    }
+}
+
+/**
+ * @brief Gets the file of a key in the disk tier.
+ * @param key The content hash of the run.
+ * @return The filename.
+ */
+std::string ResultCache::entryFilename(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.tally", static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+/**
+ * @brief Inserts or refreshes an in-memory entry and evicts the least recently used ones.
+ *
+ * The caller must hold the mutex.
+ *
+ * @param key The content hash of the run.
+ * @param tally The results.
+ */
+void ResultCache::insert(uint64_t key, const SeasonTally &tally)
+{
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    auto entry = entryIndex.find(key);
+    if (entry != entryIndex.end())
+    {
+        entries.splice(entries.begin(), entries, entry->second);
+        return;
+    }
+
+    entries.emplace_front(key, tally);
+    entryIndex[key] = entries.begin();
+    while (entries.size() > capacity)
+    {
+        entryIndex.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "SeasonTally.h"
+
+// Content-addressed cache of simulated results.
+// The key is a hash of everything the results depend on: the initial season state
+// (ratings, schedule and completed results), the model tables and the simulation
+// options. Changing any game changes the key, so entries never go stale and are
+// never invalidated explicitly. Recently used results are kept in memory; with a
+// directory, every result is also written there and survives the process.
+class ResultCache
+{
+public:
+    ResultCache(size_t entryCapacity, const std::string &cacheDirectory);
+
+    bool lookup(uint64_t key, SeasonTally &tally);
+    void store(uint64_t key, const SeasonTally &tally);
+
+private:
+    std::string entryFilename(uint64_t key) const;
+    void insert(uint64_t key, const SeasonTally &tally);
+
+    size_t capacity;       // Entries kept in memory
+    std::string directory; // Directory of the disk tier, empty for none
+
+    std::mutex mutex;                                                                            // Guards the entries
+    std::list<std::pair<uint64_t, SeasonTally>> entries;                                         // Most recently used first
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, SeasonTally>>::iterator> entryIndex; // Entry of each key
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,185 @@
+#include "RunCheckpoint.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Fingerprint.h"
+
+static_assert(std::is_trivially_copyable<SeasonTally>::value, "SeasonTally is saved as raw bytes");
+
+// Identifies checkpoint files
+static const char CHECKPOINT_MAGIC[8] = {'N', 'F', 'L', 'C', 'K', 'P', 'T', '\0'};
+
+/**
+ * @brief Appends the bytes of a value to a buffer.
+ * @param buffer The buffer.
+ * @param value The value to append.
+ */
+template <typename T>
+static void appendValue(std::string &buffer, const T &value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/**
+ * @brief Reads a value from a buffer and advances the position.
+ * @param buffer The buffer.
+ * @param position The read position, advanced past the value.
+ * @param value Set to the value read.
+ */
+template <typename T>
+static void readValue(const std::string &buffer, size_t &position, T &value)
+{
+    std::memcpy(&value, buffer.data() + position, sizeof(value));
+    position += sizeof(value);
+}
+
+/**
+ * @brief Writes the checkpoint to a file.
+ *
+ * The checkpoint is written to a temporary file first and renamed over the old one,
+ * so a run killed while saving still leaves the previous checkpoint intact.
+ *
+ * @param filename The checkpoint file.
+ * @return False if the file could not be written.
+ */
+bool RunCheckpoint::save(const std::string &filename) const
+{
+    std::string buffer(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    appendValue(buffer, VERSION);
+    appendValue(buffer, static_cast<uint32_t>(sizeof(SeasonTally)));
+    appendValue(buffer, seed);
+    appendValue(buffer, leagueFingerprint);
+    appendValue(buffer, modelFingerprint);
+    appendValue(buffer, static_cast<int64_t>(targetSeasons));
+    appendValue(buffer, static_cast<int64_t>(completedSeasons));
+    appendValue(buffer, static_cast<uint8_t>(mathMode));
+    appendValue(buffer, static_cast<uint8_t>(antithetic));
+    appendValue(buffer, static_cast<uint8_t>(controlVariates));
+    appendValue(buffer, static_cast<int32_t>(importanceTeam));
+    appendValue(buffer, importanceTilt);
+    appendValue(buffer, tally);
+
+    Fingerprint checksum;
+    checksum.add(buffer.data(), buffer.size());
+    appendValue(buffer, checksum.hash);
+
+    // Write to a temporary file of this save only, so saves of the same file from
+    // several threads or processes never interleave, then move it into place
+    std::string tempFilename = filename + ".tmp.XXXXXX";
+    int descriptor = mkstemp(&tempFilename[0]);
+    if (descriptor < 0)
+    {
+        std::cerr << "Error: Could not create checkpoint " << tempFilename << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    fchmod(descriptor, 0644);
+
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t count = write(descriptor, buffer.data() + written, buffer.size() - written);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            break;
+        written += static_cast<size_t>(count);
+    }
+    if (close(descriptor) != 0 || written < buffer.size())
+    {
+        std::cerr << "Error: Could not write checkpoint " << tempFilename << std::endl;
+        unlink(tempFilename.c_str());
+        return false;
+    }
+
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::cerr << "Error: Could not replace checkpoint " << filename << std::endl;
+        unlink(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a checkpoint from a file.
+ * @param filename The checkpoint file.
+ * @return False if the file is missing, truncated, corrupt or from another build.
+ */
+bool RunCheckpoint::load(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open checkpoint " << filename << std::endl;
+        return false;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const size_t expectedSize = sizeof(CHECKPOINT_MAGIC) + 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t) + 2 * sizeof(int64_t) +
+                                3 * sizeof(uint8_t) + sizeof(int32_t) + sizeof(double) + sizeof(SeasonTally) + sizeof(uint64_t);
+    if (buffer.size() != expectedSize || std::memcmp(buffer.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0)
+    {
+        std::cerr << "Error: " << filename << " is not a checkpoint of this build" << std::endl;
+        return false;
+    }
+
+    Fingerprint checksum;
+    checksum.add(buffer.data(), buffer.size() - sizeof(uint64_t));
+    uint64_t storedChecksum;
+    size_t position = buffer.size() - sizeof(uint64_t);
+    readValue(buffer, position, storedChecksum);
+    if (storedChecksum != checksum.hash)
+    {
+        std::cerr << "Error: Checkpoint " << filename << " is corrupt" << std::endl;
+        return false;
+    }
+
+    uint32_t version, tallySize;
+    int64_t target, completed;
+    uint8_t mode, antitheticFlag, controlFlag;
+    int32_t team;
+    position = sizeof(CHECKPOINT_MAGIC);
+    readValue(buffer, position, version);
+    readValue(buffer, position, tallySize);
+    if (version != VERSION || tallySize != sizeof(SeasonTally))
+    {
+        std::cerr << "Error: " << filename << " is not a checkpoint of this build" << std::endl;
+        return false;
+    }
+
+    readValue(buffer, position, seed);
+    readValue(buffer, position, leagueFingerprint);
+    readValue(buffer, position, modelFingerprint);
+    readValue(buffer, position, target);
+    readValue(buffer, position, completed);
+    readValue(buffer, position, mode);
+    readValue(buffer, position, antitheticFlag);
+    readValue(buffer, position, controlFlag);
+    readValue(buffer, position, team);
+    readValue(buffer, position, importanceTilt);
+    readValue(buffer, position, tally);
+
+    targetSeasons = target;
+    completedSeasons = completed;
+    mathMode = static_cast<MathMode>(mode);
+    antithetic = antitheticFlag != 0;
+    controlVariates = controlFlag != 0;
+    importanceTeam = team;
+
+    if (completedSeasons != tally.seasons || completedSeasons > targetSeasons)
+    {
+        std::cerr << "Error: Checkpoint " << filename << " is inconsistent" << std::endl;
+        return false;
+    }
+    return true;
+}
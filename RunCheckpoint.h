@@ -0,0 +1,38 @@
+#ifndef RUNCHECKPOINT_H
+#define RUNCHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+
+#include "EloMath.h"
+#include "SeasonTally.h"
+
+// Progress of a multi-season run, saved periodically so a killed run can resume.
+// Every season draws from a random stream keyed by the seed and the season index,
+// so the number of completed seasons is the whole random number position, and the
+// tally sums are exact, so a resumed run ends with the same results as one that
+// never stopped.
+//
+// The file is a fixed header, the raw tally and a checksum of both. It is only
+// meant to be read back by the same build on the same machine.
+struct RunCheckpoint
+{
+    static constexpr uint32_t VERSION = 4;
+
+    uint64_t seed = 0;                   // Seed of the run
+    uint64_t leagueFingerprint = 0;      // Hash of the initial season state the run started from
+    uint64_t modelFingerprint = 0;       // Hash of the model version and tables the seasons were simulated with
+    long long targetSeasons = 0;         // Seasons the run was asked for
+    long long completedSeasons = 0;      // Seasons simulated and included in the tally
+    MathMode mathMode = MathMode::Exact; // Options the seasons were simulated with
+    bool antithetic = false;
+    bool controlVariates = false;
+    int importanceTeam = -1;
+    double importanceTilt = 0.0;
+    SeasonTally tally;                   // Results of the completed seasons
+
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename);
+};
+
+#endif // RUNCHECKPOINT_H
@@ -0,0 +1,83 @@
+#ifndef SEASONBATCH_H
+#define SEASONBATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "SeasonState.h"
+#include "SimdLanes.h"
+
+// Regular season state of SIMD_LANES seasons simulated in lockstep.
+// Every season plays the same schedule, so the batched kernel walks the games
+// once and keeps one lane per season in the team arrays. Per-game results are
+// stored lane-minor (SIMD_LANES consecutive values per game id) and copied into
+// a scalar SeasonState per lane for the playoffs.
+struct SeasonBatch
+{
+    // Team arrays, one lane per season
+    int numTeams = 0;
+    LaneDouble teamElo[MAX_TEAMS];          // Current Elo rating
+    LaneDouble teamWins[MAX_TEAMS];         // Wins so far (ties count half)
+    LaneDouble teamExpectedWins[MAX_TEAMS]; // Wins expected from the odds of the games so far
+
+    // Game arrays, SIMD_LANES values per game id
+    int numGames = 0;
+    std::vector<double> gameOdds;         // Probability of the home team winning
+    std::vector<int16_t> gameHomeScore;   // Home team score
+    std::vector<int16_t> gameAwayScore;   // Away team score
+
+    /**
+     * @brief Starts every lane from the same season state.
+     * @param state The initial season state.
+     */
+    void load(const SeasonState &state)
+    {
+        numTeams = state.numTeams;
+        for (int team = 0; team < MAX_TEAMS; ++team)
+        {
+            teamElo[team] = broadcastLanes(state.teamElo[team]);
+            teamWins[team] = broadcastLanes(state.teamWins[team]);
+            teamExpectedWins[team] = broadcastLanes(state.teamExpectedWins[team]);
+        }
+
+        numGames = state.numGames;
+        gameOdds.resize(static_cast<size_t>(numGames) * SIMD_LANES);
+        gameHomeScore.resize(static_cast<size_t>(numGames) * SIMD_LANES);
+        gameAwayScore.resize(static_cast<size_t>(numGames) * SIMD_LANES);
+    }
+
+    /**
+     * @brief Copies the regular season of one lane into a season state.
+     *
+     * The state must be the one the batch was loaded from; the games it has not
+     * completed yet are the ones the batch simulated, and are added to its
+     * tiebreaker records.
+     *
+     * @param lane The lane to copy.
+     * @param state The season state to complete.
+     */
+    void extractLane(int lane, SeasonState &state) const
+    {
+        for (int team = 0; team < numTeams; ++team)
+        {
+            state.teamElo[team] = teamElo[team][lane];
+            state.teamWins[team] = static_cast<float>(teamWins[team][lane]);
+            state.teamExpectedWins[team] = teamExpectedWins[team][lane];
+        }
+
+        for (int gameId = 0; gameId < numGames; ++gameId)
+        {
+            if (state.gameComplete[gameId])
+                continue;
+
+            size_t index = static_cast<size_t>(gameId) * SIMD_LANES + lane;
+            state.gameOdds[gameId] = gameOdds[index];
+            state.gameHomeScore[gameId] = gameHomeScore[index];
+            state.gameAwayScore[gameId] = gameAwayScore[index];
+            state.gameComplete[gameId] = 1;
+            state.recordResult(gameId);
+        }
+    }
+};
+
+#endif // SEASONBATCH_H
@@ -0,0 +1,223 @@
+#ifndef SEASONRNG_H
+#define SEASONRNG_H
+
+#include <array>
+#include <cstdint>
+
+#include "SimdLanes.h"
+
+// Counter-based random number stream for one simulated season.
+// Every uniform is a pure function of (seed, season, draw index) computed with
+// the Philox4x32-10 generator, so a season produces the same draws no matter
+// which thread simulates it, and constructing a stream costs nothing.
+//
+// With antithetic sampling, seasons 2k and 2k + 1 share the stream of index k
+// and the odd season draws the mirror image 1 - 2^-53 - u of every uniform u.
+class SeasonRng
+{
+public:
+    // Largest uniform; mirroring u to MAX_UNIFORM - u maps the 2^-53 grid onto itself
+    static constexpr double MAX_UNIFORM = 1.0 - 0x1p-53;
+
+    /**
+     * @brief Constructs the random stream of a season.
+     * @param seed The user-supplied seed of the run.
+     * @param season The index of the season within the run.
+     * @param antithetic Whether seasons are drawn in antithetic pairs.
+     */
+    SeasonRng(uint64_t seed, uint64_t season, bool antithetic)
+        : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          seasonIndex(antithetic ? season >> 1 : season),
+          mirrored(antithetic && (season & 1) != 0),
+          drawIndex(0)
+    {
+    }
+
+    /**
+     * @brief Draws the next uniform number.
+     * @return A uniform number in [0, 1) with 53 random bits.
+     */
+    double nextUniform()
+    {
+        // Every Philox block yields two uniforms
+        if ((drawIndex & 1) == 0)
+        {
+            block = philox({static_cast<uint32_t>(seasonIndex), static_cast<uint32_t>(seasonIndex >> 32),
+                            static_cast<uint32_t>(drawIndex >> 1), static_cast<uint32_t>(drawIndex >> 33)},
+                           key);
+        }
+
+        int half = static_cast<int>(drawIndex & 1) * 2;
+        ++drawIndex;
+        double uniform = toUniform(block[half], block[half + 1]);
+        return mirrored ? MAX_UNIFORM - uniform : uniform;
+    }
+
+    /**
+     * @brief Gets the number of uniforms drawn so far.
+     * @return The index of the next draw.
+     */
+    uint64_t getDrawIndex() const
+    {
+        return drawIndex;
+    }
+
+    /**
+     * @brief Moves the stream to a draw index, as if that many uniforms had been drawn.
+     * @param index The index of the next draw.
+     */
+    void seek(uint64_t index)
+    {
+        drawIndex = index;
+        if ((drawIndex & 1) != 0)
+        {
+            block = philox({static_cast<uint32_t>(seasonIndex), static_cast<uint32_t>(seasonIndex >> 32),
+                            static_cast<uint32_t>(drawIndex >> 1), static_cast<uint32_t>(drawIndex >> 33)},
+                           key);
+        }
+    }
+
+    /**
+     * @brief Computes the Philox4x32-10 block of a counter.
+     * @param counter The 128-bit counter.
+     * @param key The 64-bit key.
+     * @return The four 32-bit random words of the block.
+     */
+    static std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+    {
+        constexpr uint32_t MULTIPLIER_0 = 0xD2511F53;
+        constexpr uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+        constexpr uint32_t WEYL_0 = 0x9E3779B9;
+        constexpr uint32_t WEYL_1 = 0xBB67AE85;
+
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t product0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+            uint64_t product1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                       static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                       static_cast<uint32_t>(product0)};
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+        }
+
+        return counter;
+    }
+
+    /**
+     * @brief Converts two random words into a uniform number.
+     * @param high The word providing the upper 27 bits.
+     * @param low The word providing the lower 26 bits.
+     * @return A uniform number in [0, 1).
+     */
+    static double toUniform(uint32_t high, uint32_t low)
+    {
+        return ((high >> 5) * 67108864.0 + (low >> 6)) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    std::array<uint32_t, 2> key;   // Philox key derived from the seed
+    uint64_t seasonIndex;          // Upper half of the counter
+    bool mirrored;                 // Whether this is the mirrored season of an antithetic pair
+    uint64_t drawIndex;            // Number of uniforms drawn so far
+    std::array<uint32_t, 4> block{}; // Current Philox block
+};
+
+// The random streams of SIMD_LANES consecutive seasons drawn in lockstep.
+// Lane i yields exactly the uniforms of SeasonRng(seed, firstSeason + i, antithetic), so a
+// season can move from the batched kernel to the scalar one by seeking its
+// SeasonRng to getDrawIndex().
+class SeasonRngLanes
+{
+public:
+    /**
+     * @brief Constructs the random streams of SIMD_LANES consecutive seasons.
+     * @param seed The user-supplied seed of the run.
+     * @param firstSeason The index of the season in lane 0.
+     * @param antithetic Whether seasons are drawn in antithetic pairs.
+     */
+    SeasonRngLanes(uint64_t seed, uint64_t firstSeason, bool antithetic)
+        : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          drawIndex(0)
+    {
+        for (int lane = 0; lane < SIMD_LANES; ++lane)
+        {
+            uint64_t season = firstSeason + lane;
+            uint64_t stream = antithetic ? season >> 1 : season;
+            seasonLow[lane] = static_cast<uint32_t>(stream);
+            seasonHigh[lane] = static_cast<uint32_t>(stream >> 32);
+            mirrored[lane] = antithetic && (season & 1) != 0 ? -1 : 0;
+        }
+    }
+
+    /**
+     * @brief Draws the next uniform number of every lane.
+     * @return Uniform numbers in [0, 1) with 53 random bits.
+     */
+    LaneDouble nextUniform()
+    {
+        if ((drawIndex & 1) == 0)
+        {
+            LaneUInt zero = {};
+            block = philox({seasonLow, seasonHigh,
+                            zero + static_cast<uint32_t>(drawIndex >> 1), zero + static_cast<uint32_t>(drawIndex >> 33)},
+                           key);
+        }
+
+        int half = static_cast<int>(drawIndex & 1) * 2;
+        ++drawIndex;
+        LaneDouble high = __builtin_convertvector(block[half] >> 5, LaneDouble);
+        LaneDouble low = __builtin_convertvector(block[half + 1] >> 6, LaneDouble);
+        LaneDouble uniform = (high * 67108864.0 + low) * (1.0 / 9007199254740992.0);
+        return mirrored ? SeasonRng::MAX_UNIFORM - uniform : uniform;
+    }
+
+    /**
+     * @brief Gets the number of uniforms drawn so far in every lane.
+     * @return The index of the next draw.
+     */
+    uint64_t getDrawIndex() const
+    {
+        return drawIndex;
+    }
+
+    /**
+     * @brief Computes the Philox4x32-10 blocks of one counter per lane.
+     * @param counter The 128-bit counters as four 32-bit words held in 64-bit lanes.
+     * @param key The 64-bit key shared by all lanes.
+     * @return The four 32-bit random words of every block.
+     */
+    static std::array<LaneUInt, 4> philox(std::array<LaneUInt, 4> counter, std::array<uint32_t, 2> key)
+    {
+        constexpr uint64_t MULTIPLIER_0 = 0xD2511F53;
+        constexpr uint64_t MULTIPLIER_1 = 0xCD9E8D57;
+        constexpr uint32_t WEYL_0 = 0x9E3779B9;
+        constexpr uint32_t WEYL_1 = 0xBB67AE85;
+        constexpr uint64_t LOW_WORD = 0xFFFFFFFF;
+
+        for (int round = 0; round < 10; ++round)
+        {
+            LaneUInt product0 = counter[0] * MULTIPLIER_0;
+            LaneUInt product1 = counter[2] * MULTIPLIER_1;
+            counter = {(product1 >> 32) ^ counter[1] ^ static_cast<uint64_t>(key[0]),
+                       product1 & LOW_WORD,
+                       (product0 >> 32) ^ counter[3] ^ static_cast<uint64_t>(key[1]),
+                       product0 & LOW_WORD};
+            key[0] += WEYL_0;
+            key[1] += WEYL_1;
+        }
+
+        return counter;
+    }
+
+private:
+    std::array<uint32_t, 2> key; // Philox key derived from the seed
+    LaneUInt seasonLow;          // Lower word of every lane's season index
+    LaneUInt seasonHigh;         // Upper word of every lane's season index
+    LaneInt mirrored;            // All ones in the lanes of mirrored antithetic seasons
+    uint64_t drawIndex;          // Number of uniforms drawn so far
+    std::array<LaneUInt, 4> block{}; // Current Philox block of every lane
+};
+
+#endif // SEASONRNG_H
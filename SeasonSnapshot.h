@@ -0,0 +1,54 @@
+#ifndef SEASONSNAPSHOT_H
+#define SEASONSNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Team.h"
+
+// Results of one week's games and the league after them.
+// Games are indexed relative to the first game id of the week.
+struct SnapshotWeek
+{
+    int firstGame = 0;                        // Game id of the week's first game
+    std::vector<int16_t> homeScore;           // Home team score
+    std::vector<int16_t> awayScore;           // Away team score
+    std::vector<uint8_t> complete;            // Non-zero for games with a known result
+    std::vector<double> odds;                 // Home odds of completed games when they were played
+    std::array<double, MAX_TEAMS> eloAfter{}; // Elo ratings after this and all earlier weeks
+    std::array<float, MAX_TEAMS> winsAfter{}; // Wins after this and all earlier weeks (ties count half)
+};
+
+// Copy-on-write snapshot of the known results of a season.
+// Weeks are immutable once built and shared between snapshots, so copying a
+// snapshot only copies one pointer per week. Setting a result replaces the weeks
+// from the game's week on, whose Elo ratings depend on it; the earlier weeks stay
+// shared with every snapshot the new one was forked from.
+struct SeasonSnapshot
+{
+    int numTeams = 0;
+    std::array<double, MAX_TEAMS> preseasonElo{};           // Elo ratings before the first week
+    std::vector<std::shared_ptr<const SnapshotWeek>> weeks; // Results per week
+
+    /**
+     * @brief Creates a what-if branch of the snapshot.
+     * @return A snapshot sharing every week with this one.
+     */
+    SeasonSnapshot fork() const
+    {
+        return *this;
+    }
+
+    /**
+     * @brief Gets the Elo ratings after all known results.
+     * @return The Elo rating per schedule index.
+     */
+    const std::array<double, MAX_TEAMS> &currentElo() const
+    {
+        return weeks.empty() ? preseasonElo : weeks.back()->eloAfter;
+    }
+};
+
+#endif // SEASONSNAPSHOT_H
@@ -0,0 +1,168 @@
+#ifndef SEASONSTATE_H
+#define SEASONSTATE_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Team.h"
+
+// Number of conferences and playoff teams per conference
+constexpr int NUM_CONFERENCES = 2;
+constexpr int PLAYOFF_TEAMS = 7;
+
+// Results of a team's games against one opponent
+struct HeadToHeadRecord
+{
+    int16_t pointDifferential; // Points scored minus points allowed, over all games
+    uint8_t wins;
+    uint8_t losses;
+    uint8_t ties;
+};
+
+// Results between every pair of teams of one season, indexed by schedule index.
+// Every game is counted, so both games of a division series are kept; recording a
+// result touches two fixed records and clearing the matrix is a memset.
+struct HeadToHeadMatrix
+{
+    std::array<std::array<HeadToHeadRecord, MAX_TEAMS>, MAX_TEAMS> records{}; // Record per team against each opponent
+    std::array<uint32_t, MAX_TEAMS> opponents{}; // Bit per opponent played, so tiebreakers skip the others
+
+    /**
+     * @brief Gets the record of a team against one opponent.
+     * @param team The schedule index of the team.
+     * @param opponent The schedule index of the opponent.
+     * @return The record, all zero if they have not played.
+     */
+    const HeadToHeadRecord &against(int team, int opponent) const
+    {
+        return records[team][opponent];
+    }
+
+    /**
+     * @brief Adds the result of a game.
+     * @param home The schedule index of the home team.
+     * @param away The schedule index of the away team.
+     * @param homeScore The score of the home team.
+     * @param awayScore The score of the away team.
+     */
+    void record(int home, int away, int homeScore, int awayScore)
+    {
+        const uint8_t homeWin = homeScore > awayScore;
+        const uint8_t awayWin = homeScore < awayScore;
+        const uint8_t tie = homeScore == awayScore;
+        const int16_t margin = static_cast<int16_t>(homeScore - awayScore);
+
+        // Counted without branches, since the outcome is a coin flip for the branch predictor
+        HeadToHeadRecord &homeRecord = records[home][away];
+        HeadToHeadRecord &awayRecord = records[away][home];
+        homeRecord.pointDifferential += margin;
+        homeRecord.wins += homeWin;
+        homeRecord.losses += awayWin;
+        homeRecord.ties += tie;
+        awayRecord.pointDifferential -= margin;
+        awayRecord.wins += awayWin;
+        awayRecord.losses += homeWin;
+        awayRecord.ties += tie;
+        opponents[home] |= 1u << away;
+        opponents[away] |= 1u << home;
+    }
+
+    /**
+     * @brief Takes back the result of a game added with record.
+     * @param home The schedule index of the home team.
+     * @param away The schedule index of the away team.
+     * @param homeScore The score of the home team.
+     * @param awayScore The score of the away team.
+     */
+    void remove(int home, int away, int homeScore, int awayScore)
+    {
+        HeadToHeadRecord &homeRecord = records[home][away];
+        HeadToHeadRecord &awayRecord = records[away][home];
+        homeRecord.pointDifferential -= static_cast<int16_t>(homeScore - awayScore);
+        homeRecord.wins -= homeScore > awayScore;
+        homeRecord.losses -= homeScore < awayScore;
+        homeRecord.ties -= homeScore == awayScore;
+        awayRecord.pointDifferential += static_cast<int16_t>(homeScore - awayScore);
+        awayRecord.wins -= homeScore < awayScore;
+        awayRecord.losses -= homeScore > awayScore;
+        awayRecord.ties -= homeScore == awayScore;
+        if (homeRecord.wins + homeRecord.losses + homeRecord.ties == 0)
+        {
+            opponents[home] &= ~(1u << away);
+            opponents[away] &= ~(1u << home);
+        }
+    }
+
+    /**
+     * @brief Removes all results.
+     */
+    void clear()
+    {
+        std::memset(records.data(), 0, sizeof(records));
+        std::memset(opponents.data(), 0, sizeof(opponents));
+    }
+};
+
+// Flat struct-of-arrays state of one simulated season.
+// Teams are indexed by schedule index and games by game id, so simulating a game
+// only touches a handful of contiguous arrays instead of the shared_ptr graph of
+// Team and Game objects, which stay the user-facing view of the league.
+struct SeasonState
+{
+    // Team arrays
+    int numTeams = 0;
+    std::array<double, MAX_TEAMS> teamElo{};          // Current Elo rating
+    std::array<float, MAX_TEAMS> teamWins{};          // Wins so far (ties count half)
+    std::array<double, MAX_TEAMS> teamExpectedWins{}; // Wins expected from the odds of the games so far
+    std::array<int8_t, MAX_TEAMS> playoffRound{};     // Furthest playoff round reached
+
+    // Game arrays
+    int numGames = 0;
+    std::vector<uint8_t> gameHome;          // Schedule index of the home team
+    std::vector<uint8_t> gameAway;          // Schedule index of the away team
+    std::vector<uint8_t> gameWeek;          // Week the game is played in
+    std::vector<int16_t> gameHomeScore;     // Home team score
+    std::vector<int16_t> gameAwayScore;     // Away team score
+    std::vector<double> gameOdds;           // Probability of the home team winning
+    std::vector<uint8_t> gameComplete;      // Non-zero once the game has been played
+
+    // Head-to-head results of the completed regular season games, kept up to date by
+    // recordResult so breaking a tie never has to walk the schedule. Division,
+    // conference and common games records are sums over rows of the matrix.
+    HeadToHeadMatrix headToHead;
+
+    // Playoff seeding per conference, best seed first
+    std::array<std::array<int8_t, PLAYOFF_TEAMS>, NUM_CONFERENCES> playoffSeeds{};
+
+    // Likelihood ratio of the season's draws under importance sampling, 1 otherwise
+    double weight = 1.0;
+
+    /**
+     * @brief Resizes the game arrays.
+     * @param count The number of games in the season.
+     */
+    void resizeGames(int count)
+    {
+        numGames = count;
+        gameHome.assign(count, 0);
+        gameAway.assign(count, 0);
+        gameWeek.assign(count, 0);
+        gameHomeScore.assign(count, 0);
+        gameAwayScore.assign(count, 0);
+        gameOdds.assign(count, 0.0);
+        gameComplete.assign(count, 0);
+    }
+
+    /**
+     * @brief Adds the result of a completed game to the tiebreaker records.
+     * @param gameId The game, with its scores set.
+     */
+    void recordResult(int gameId)
+    {
+        headToHead.record(gameHome[gameId], gameAway[gameId], gameHomeScore[gameId], gameAwayScore[gameId]);
+    }
+};
+
+#endif // SEASONSTATE_H
@@ -0,0 +1,363 @@
+#include "SeasonTally.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Quantizes a season weight for the exact weighted sums.
+ * @param weight The weight, at least 0.
+ * @return The weight in multiples of 1 / WEIGHT_SCALE.
+ */
+static FixedSum quantizeWeight(double weight)
+{
+    return static_cast<FixedSum>(weight * WEIGHT_SCALE + 0.5);
+}
+
+/**
+ * @brief Records a season; its team results are added with addTeamResult.
+ * @param weight The likelihood ratio of the season, 1 without importance sampling.
+ */
+void SeasonTally::addSeason(double weight)
+{
+    ++seasons;
+    weightSums += quantizeWeight(weight);
+    weightSquareSums += quantizeWeight(weight * weight);
+}
+
+/**
+ * @brief Records one team's result for a season.
+ * @param teamIndex The schedule index of the team.
+ * @param wins The number of wins of the team in the season.
+ * @param playoffRound The furthest playoff round the team reached.
+ * @param seed The team's playoff seed (1-7), 0 if it missed the playoffs.
+ * @param control The team's regular season wins minus its expected wins.
+ * @param weight The likelihood ratio of the season, 1 without importance sampling.
+ */
+void SeasonTally::addTeamResult(int teamIndex, float wins, int playoffRound, int seed, double control, double weight)
+{
+    long long halfWins = static_cast<long long>(wins * 2.0f);
+    int winBin = static_cast<int>(std::min<long long>(halfWins, NUM_WIN_BINS - 1));
+    winTotals[teamIndex] += wins;
+    winSquareSums[teamIndex] += halfWins * halfWins;
+    ++roundCounts[teamIndex][playoffRound];
+    ++winCounts[teamIndex][winBin];
+    ++seedCounts[teamIndex][seed];
+
+    FixedSum quantized = std::llround(control * CONTROL_SCALE);
+    controlSums[teamIndex] += quantized;
+    controlSquareSums[teamIndex] += quantized * quantized;
+    winControlSums[teamIndex] += halfWins * quantized;
+    roundControlSums[teamIndex][playoffRound] += quantized;
+
+    FixedSum quantizedWeight = quantizeWeight(weight);
+    weightedWinSums[teamIndex] += halfWins * quantizedWeight;
+    weightedWinSquareSums[teamIndex] += halfWins * halfWins * quantizedWeight;
+    roundWeightSums[teamIndex][playoffRound] += quantizedWeight;
+    roundWeightSquareSums[teamIndex][playoffRound] += quantizeWeight(weight * weight);
+    winWeightSums[teamIndex][winBin] += quantizedWeight;
+    seedWeightSums[teamIndex][seed] += quantizedWeight;
+}
+
+/**
+ * @brief Adds the results accumulated by another tally to this one.
+ * @param other The tally to merge.
+ */
+void SeasonTally::merge(const SeasonTally &other)
+{
+    seasons += other.seasons;
+    weightSums += other.weightSums;
+    weightSquareSums += other.weightSquareSums;
+    for (int team = 0; team < MAX_TEAMS; ++team)
+    {
+        winTotals[team] += other.winTotals[team];
+        winSquareSums[team] += other.winSquareSums[team];
+        controlSums[team] += other.controlSums[team];
+        controlSquareSums[team] += other.controlSquareSums[team];
+        winControlSums[team] += other.winControlSums[team];
+        weightedWinSums[team] += other.weightedWinSums[team];
+        weightedWinSquareSums[team] += other.weightedWinSquareSums[team];
+        for (int round = 0; round < NUM_PLAYOFF_ROUNDS; ++round)
+        {
+            roundCounts[team][round] += other.roundCounts[team][round];
+            roundControlSums[team][round] += other.roundControlSums[team][round];
+            roundWeightSums[team][round] += other.roundWeightSums[team][round];
+            roundWeightSquareSums[team][round] += other.roundWeightSquareSums[team][round];
+        }
+        for (int bin = 0; bin < NUM_WIN_BINS; ++bin)
+        {
+            winCounts[team][bin] += other.winCounts[team][bin];
+            winWeightSums[team][bin] += other.winWeightSums[team][bin];
+        }
+        for (int seed = 0; seed <= PLAYOFF_TEAMS; ++seed)
+        {
+            seedCounts[team][seed] += other.seedCounts[team][seed];
+            seedWeightSums[team][seed] += other.seedWeightSums[team][seed];
+        }
+    }
+}
+
+/**
+ * @brief Counts the seasons in which a team reached at least the given playoff round.
+ * @param teamIndex The schedule index of the team.
+ * @param minRound The playoff round to reach.
+ * @return The number of seasons in which the team reached the round.
+ */
+long long SeasonTally::countReached(int teamIndex, int minRound) const
+{
+    long long count = 0;
+    for (int round = minRound; round < NUM_PLAYOFF_ROUNDS; ++round)
+    {
+        count += roundCounts[teamIndex][round];
+    }
+    return count;
+}
+
+/**
+ * @brief Sums the quantized controls of the seasons in which a team reached a playoff round.
+ * @param teamIndex The schedule index of the team.
+ * @param minRound The playoff round to reach.
+ * @return The sum of the quantized controls.
+ */
+FixedSum SeasonTally::controlReached(int teamIndex, int minRound) const
+{
+    FixedSum sum = 0;
+    for (int round = minRound; round < NUM_PLAYOFF_ROUNDS; ++round)
+    {
+        sum += roundControlSums[teamIndex][round];
+    }
+    return sum;
+}
+
+/**
+ * @brief Sums the quantized weights of the seasons in which a team reached a playoff round.
+ * @param teamIndex The schedule index of the team.
+ * @param minRound The playoff round to reach.
+ * @param squared Whether to sum the squared weights instead.
+ * @return The sum of the quantized weights.
+ */
+FixedSum SeasonTally::weightReached(int teamIndex, int minRound, bool squared) const
+{
+    FixedSum sum = 0;
+    for (int round = minRound; round < NUM_PLAYOFF_ROUNDS; ++round)
+    {
+        sum += squared ? roundWeightSquareSums[teamIndex][round] : roundWeightSums[teamIndex][round];
+    }
+    return sum;
+}
+
+/**
+ * @brief Computes the regression coefficient of an estimate on a team's control.
+ * @param teamIndex The schedule index of the team.
+ * @param mean The plain sample mean of the estimated quantity.
+ * @param productSum The sum of the quantity times the control over all seasons.
+ * @param controlMean Set to the sample mean of the control.
+ * @param controlVariance Set to the sample variance of the control.
+ * @return The coefficient, or 0 if the control does not vary.
+ */
+double SeasonTally::controlCoefficient(int teamIndex, double mean, double productSum, double &controlMean, double &controlVariance) const
+{
+    double n = static_cast<double>(seasons);
+    controlMean = static_cast<double>(controlSums[teamIndex]) / CONTROL_SCALE / n;
+    controlVariance = static_cast<double>(controlSquareSums[teamIndex]) / (CONTROL_SCALE * CONTROL_SCALE) / n - controlMean * controlMean;
+    if (controlVariance <= 0.0)
+    {
+        controlVariance = 0.0;
+        return 0.0;
+    }
+
+    double covariance = productSum / n - mean * controlMean;
+    return covariance / controlVariance;
+}
+
+/**
+ * @brief Estimates a team's average number of wins.
+ * @param teamIndex The schedule index of the team.
+ * @param estimator How to estimate the average.
+ * @return The estimated average wins, or 0 if no season was recorded.
+ */
+double SeasonTally::averageWins(int teamIndex, Estimator estimator) const
+{
+    if (seasons == 0)
+    {
+        return 0.0;
+    }
+
+    if (estimator == Estimator::Importance)
+    {
+        return static_cast<double>(weightedWinSums[teamIndex]) / (2.0 * WEIGHT_SCALE) / seasons;
+    }
+
+    double mean = winTotals[teamIndex] / seasons;
+    if (estimator == Estimator::Plain)
+    {
+        return mean;
+    }
+
+    double controlMean, controlVariance;
+    double productSum = static_cast<double>(winControlSums[teamIndex]) / (2.0 * CONTROL_SCALE);
+    return mean - controlCoefficient(teamIndex, mean, productSum, controlMean, controlVariance) * controlMean;
+}
+
+/**
+ * @brief Computes the standard deviation of a team's wins over the seasons.
+ *
+ * This is the spread of the win distribution itself, not the precision of the average.
+ * Under importance sampling the moments are weighted by the likelihood ratios.
+ *
+ * @param teamIndex The schedule index of the team.
+ * @param estimator How the results are estimated.
+ * @return The standard deviation of the team's wins.
+ */
+double SeasonTally::winStandardDeviation(int teamIndex, Estimator estimator) const
+{
+    if (seasons < 2)
+    {
+        return 0.0;
+    }
+
+    double n = static_cast<double>(seasons);
+    double variance;
+    if (estimator == Estimator::Importance)
+    {
+        double mean = averageWins(teamIndex, estimator);
+        double meanSquare = static_cast<double>(weightedWinSquareSums[teamIndex]) / (4.0 * WEIGHT_SCALE) / n;
+        variance = meanSquare - mean * mean;
+    }
+    else
+    {
+        double mean = winTotals[teamIndex] / n;
+        variance = (static_cast<double>(winSquareSums[teamIndex]) / 4.0 - n * mean * mean) / (n - 1.0);
+    }
+    return std::sqrt(std::max(variance, 0.0));
+}
+
+/**
+ * @brief Computes the probability of a team finishing with a given win total.
+ * @param teamIndex The schedule index of the team.
+ * @param halfWins The win total in half wins (0 to 34).
+ * @param estimator How the results are estimated; the control variate is not applied.
+ * @return The probability of the win total.
+ */
+double SeasonTally::winTotalProbability(int teamIndex, int halfWins, Estimator estimator) const
+{
+    if (seasons == 0)
+    {
+        return 0.0;
+    }
+
+    if (estimator == Estimator::Importance)
+    {
+        return static_cast<double>(winWeightSums[teamIndex][halfWins]) / WEIGHT_SCALE / seasons;
+    }
+    return static_cast<double>(winCounts[teamIndex][halfWins]) / seasons;
+}
+
+/**
+ * @brief Computes the probability of a team finishing with a given playoff seed.
+ * @param teamIndex The schedule index of the team.
+ * @param seed The seed (1-7), or 0 for missing the playoffs.
+ * @param estimator How the results are estimated; the control variate is not applied.
+ * @return The probability of the seed.
+ */
+double SeasonTally::seedProbability(int teamIndex, int seed, Estimator estimator) const
+{
+    if (seasons == 0)
+    {
+        return 0.0;
+    }
+
+    if (estimator == Estimator::Importance)
+    {
+        return static_cast<double>(seedWeightSums[teamIndex][seed]) / WEIGHT_SCALE / seasons;
+    }
+    return static_cast<double>(seedCounts[teamIndex][seed]) / seasons;
+}
+
+/**
+ * @brief Estimates the probability of a team reaching at least a playoff round.
+ * @param teamIndex The schedule index of the team.
+ * @param minRound The playoff round to reach.
+ * @param estimator How to estimate the probability.
+ * @return The estimated probability, or 0 if no season was recorded.
+ */
+double SeasonTally::probability(int teamIndex, int minRound, Estimator estimator) const
+{
+    if (seasons == 0)
+    {
+        return 0.0;
+    }
+
+    if (estimator == Estimator::Importance)
+    {
+        return static_cast<double>(weightReached(teamIndex, minRound, false)) / WEIGHT_SCALE / seasons;
+    }
+
+    double mean = static_cast<double>(countReached(teamIndex, minRound)) / seasons;
+    if (estimator == Estimator::Plain)
+    {
+        return mean;
+    }
+
+    double controlMean, controlVariance;
+    double productSum = static_cast<double>(controlReached(teamIndex, minRound)) / CONTROL_SCALE;
+    double corrected = mean - controlCoefficient(teamIndex, mean, productSum, controlMean, controlVariance) * controlMean;
+    return std::min(std::max(corrected, 0.0), 1.0);
+}
+
+/**
+ * @brief Computes the half-width of the 95% confidence interval of a playoff probability.
+ *
+ * The plain estimate uses the Wilson score interval, which stays meaningful for
+ * probabilities of 0 and 1. The control-variate estimate uses the variance left after
+ * the regression and the importance estimate the variance of the weighted indicator,
+ * both with the same small-sample term as the Wilson interval. All of them treat the
+ * seasons as independent, which overstates the width for antithetic pairs.
+ *
+ * @param teamIndex The schedule index of the team.
+ * @param minRound The playoff round to reach.
+ * @param estimator The estimator the interval is for.
+ * @return The half-width of the interval as a probability, or 1 if no season was recorded.
+ */
+double SeasonTally::halfWidth(int teamIndex, int minRound, Estimator estimator) const
+{
+    if (seasons == 0)
+    {
+        return 1.0;
+    }
+
+    double n = static_cast<double>(seasons);
+    double p = countReached(teamIndex, minRound) / n;
+    double z2 = CONFIDENCE_Z * CONFIDENCE_Z;
+    double variance = p * (1.0 - p);
+
+    if (estimator == Estimator::Importance)
+    {
+        double weighted = probability(teamIndex, minRound, estimator);
+        double squareMean = static_cast<double>(weightReached(teamIndex, minRound, true)) / WEIGHT_SCALE / n;
+        variance = std::max(squareMean - weighted * weighted, 0.0);
+    }
+    else if (estimator == Estimator::ControlVariate)
+    {
+        double controlMean, controlVariance;
+        double productSum = static_cast<double>(controlReached(teamIndex, minRound)) / CONTROL_SCALE;
+        double coefficient = controlCoefficient(teamIndex, p, productSum, controlMean, controlVariance);
+        variance = std::max(variance - coefficient * coefficient * controlVariance, 0.0);
+    }
+
+    return CONFIDENCE_Z / (1.0 + z2 / n) * std::sqrt(variance / n + z2 / (4.0 * n * n));
+}
+
+/**
+ * @brief Computes the effective sample size of the importance weights.
+ * @return (sum of weights)^2 / (sum of squared weights), the number of seasons for plain sampling.
+ */
+double SeasonTally::effectiveSampleSize() const
+{
+    if (weightSquareSums == 0)
+    {
+        return 0.0;
+    }
+
+    double weightSum = static_cast<double>(weightSums) / WEIGHT_SCALE;
+    return weightSum * weightSum / (static_cast<double>(weightSquareSums) / WEIGHT_SCALE);
+}
@@ -0,0 +1,87 @@
+#ifndef SEASONTALLY_H
+#define SEASONTALLY_H
+
+#include <array>
+
+#include "SeasonState.h"
+#include "Team.h"
+
+// Number of playoff rounds tracked per team (0 = missed playoffs ... 5 = champion)
+constexpr int NUM_PLAYOFF_ROUNDS = 6;
+
+// Win totals are counted in half wins from 0 to 17, so ties get their own bins
+constexpr int MAX_REGULAR_SEASON_WINS = 17;
+constexpr int NUM_WIN_BINS = 2 * MAX_REGULAR_SEASON_WINS + 1;
+
+// Standard normal quantile of the 95% confidence intervals
+constexpr double CONFIDENCE_Z = 1.959963984540054;
+
+// Control variates are quantized to multiples of 1 / CONTROL_SCALE and summed as
+// 128-bit integers, so the sums are exact and never depend on the merge order
+constexpr double CONTROL_SCALE = 4294967296.0;
+__extension__ typedef __int128 FixedSum;
+
+// Importance weights are quantized to multiples of 1 / WEIGHT_SCALE for the same reason
+constexpr double WEIGHT_SCALE = 1099511627776.0;
+
+// How the results are estimated from the accumulated seasons
+enum class Estimator
+{
+    Plain,          // Sample means and proportions
+    ControlVariate, // Regressed on the expected-wins control
+    Importance      // Weighted by the importance sampling likelihood ratios
+};
+
+// Per-thread accumulator of season results, indexed by team schedule index.
+// Padded to a full cache line so that neighbouring workers never share one.
+// Seasons are folded into counts, sums and sums of squares as they finish, so
+// the tally has a fixed size no matter how many seasons are simulated.
+//
+// Besides the plain sums, the tally keeps the sums needed for a control-variate
+// estimator. A team's control is its regular season wins minus the wins expected
+// from the odds of its games at the time they were played, which has a mean of
+// exactly zero, so regressing on it removes the part of the noise it explains.
+// With importance sampling, every season also carries the likelihood ratio of its
+// draws, and the weighted sums give unbiased estimates under the original odds.
+struct alignas(64) SeasonTally
+{
+    long long seasons = 0;                                                        // Seasons accumulated
+    std::array<double, MAX_TEAMS> winTotals{};                                    // Sum of wins per team
+    std::array<long long, MAX_TEAMS> winSquareSums{};                             // Sum of twice the wins, squared
+    std::array<std::array<long long, NUM_PLAYOFF_ROUNDS>, MAX_TEAMS> roundCounts{}; // Seasons ending in each round
+    std::array<std::array<long long, NUM_WIN_BINS>, MAX_TEAMS> winCounts{};         // Seasons per win total, in half wins
+    std::array<std::array<long long, PLAYOFF_TEAMS + 1>, MAX_TEAMS> seedCounts{};   // Seasons per playoff seed, 0 for none
+
+    std::array<FixedSum, MAX_TEAMS> controlSums{};                                  // Sum of the quantized controls
+    std::array<FixedSum, MAX_TEAMS> controlSquareSums{};                            // Sum of their squares
+    std::array<FixedSum, MAX_TEAMS> winControlSums{};                               // Sum of twice the wins times the control
+    std::array<std::array<FixedSum, NUM_PLAYOFF_ROUNDS>, MAX_TEAMS> roundControlSums{}; // Sum of the controls per final round
+
+    FixedSum weightSums = 0;                                                          // Sum of the quantized season weights
+    FixedSum weightSquareSums = 0;                                                    // Sum of their squares
+    std::array<FixedSum, MAX_TEAMS> weightedWinSums{};                                // Sum of the weights times twice the wins
+    std::array<FixedSum, MAX_TEAMS> weightedWinSquareSums{};                          // Sum of the weights times twice the wins, squared
+    std::array<std::array<FixedSum, NUM_PLAYOFF_ROUNDS>, MAX_TEAMS> roundWeightSums{};       // Sum of the weights per final round
+    std::array<std::array<FixedSum, NUM_PLAYOFF_ROUNDS>, MAX_TEAMS> roundWeightSquareSums{}; // Sum of the squared weights per final round
+    std::array<std::array<FixedSum, NUM_WIN_BINS>, MAX_TEAMS> winWeightSums{};               // Sum of the weights per win total
+    std::array<std::array<FixedSum, PLAYOFF_TEAMS + 1>, MAX_TEAMS> seedWeightSums{};         // Sum of the weights per playoff seed
+
+    void addSeason(double weight);
+    void addTeamResult(int teamIndex, float wins, int playoffRound, int seed, double control, double weight);
+    void merge(const SeasonTally &other);
+    long long countReached(int teamIndex, int minRound) const;
+    double averageWins(int teamIndex, Estimator estimator) const;
+    double winStandardDeviation(int teamIndex, Estimator estimator) const;
+    double winTotalProbability(int teamIndex, int halfWins, Estimator estimator) const;
+    double seedProbability(int teamIndex, int seed, Estimator estimator) const;
+    double probability(int teamIndex, int minRound, Estimator estimator) const;
+    double halfWidth(int teamIndex, int minRound, Estimator estimator) const;
+    double effectiveSampleSize() const;
+
+private:
+    FixedSum controlReached(int teamIndex, int minRound) const;
+    FixedSum weightReached(int teamIndex, int minRound, bool squared) const;
+    double controlCoefficient(int teamIndex, double mean, double productSum, double &controlMean, double &controlVariance) const;
+};
+
+#endif // SEASONTALLY_H
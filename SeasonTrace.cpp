@@ -0,0 +1,574 @@
+#include "SeasonTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Identifies trace files
+static const char TRACE_MAGIC[8] = {'N', 'F', 'L', 'T', 'R', 'C', 'E', '\0'};
+
+// Names of the columns on the command line, in bit order
+static const char *const TRACE_COLUMN_NAMES[NUM_TRACE_COLUMNS] = {"outcomes", "scores", "elo", "seeds", "playoffs", "weights"};
+
+// Bits per value of the packed columns
+constexpr int OUTCOME_BITS = 2;
+constexpr int TEAM_CODE_BITS = 3;
+
+// Column indices, the bit positions of the TraceColumn flags
+constexpr int OUTCOMES_COLUMN = 0;
+constexpr int SCORES_COLUMN = 1;
+constexpr int ELO_COLUMN = 2;
+constexpr int SEEDS_COLUMN = 3;
+constexpr int PLAYOFFS_COLUMN = 4;
+constexpr int WEIGHTS_COLUMN = 5;
+
+// Fixed part of a block, before the column sizes
+struct BlockHeader
+{
+    uint64_t firstSeason;
+    uint32_t numSeasons;
+    uint32_t columnBytes[NUM_TRACE_COLUMNS];
+};
+
+/**
+ * @brief Parses a comma-separated list of column names.
+ * @param list The names, or "all" for every column.
+ * @param columns Set to the mask of the named columns.
+ * @return False if a name is unknown or the list is empty.
+ */
+bool parseTraceColumns(const std::string &list, uint32_t &columns)
+{
+    if (list == "all")
+    {
+        columns = (1u << NUM_TRACE_COLUMNS) - 1;
+        return true;
+    }
+
+    columns = 0;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = list.find(',', start);
+        std::string name = list.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        int column = 0;
+        while (column < NUM_TRACE_COLUMNS && name != TRACE_COLUMN_NAMES[column])
+        {
+            ++column;
+        }
+        if (column == NUM_TRACE_COLUMNS)
+        {
+            return false;
+        }
+        columns |= 1u << column;
+        if (end == std::string::npos)
+        {
+            break;
+        }
+        start = end + 1;
+    }
+    return columns != 0;
+}
+
+/**
+ * @brief Gets the name of a column as parseTraceColumns accepts it.
+ * @param column The column index, the bit position of its TraceColumn flag.
+ * @return The name.
+ */
+const char *traceColumnName(int column)
+{
+    return TRACE_COLUMN_NAMES[column];
+}
+
+/**
+ * @brief Appends a value to a packed column.
+ * @param block The block.
+ * @param column The column index.
+ * @param value The value, below 2^bits.
+ * @param bits The bits per value.
+ */
+static void packBits(SeasonTraceBlock &block, int column, uint32_t value, int bits)
+{
+    block.pendingBits[column] |= static_cast<uint64_t>(value) << block.pendingBitCount[column];
+    block.pendingBitCount[column] += bits;
+    while (block.pendingBitCount[column] >= 8)
+    {
+        block.columns[column].push_back(static_cast<uint8_t>(block.pendingBits[column]));
+        block.pendingBits[column] >>= 8;
+        block.pendingBitCount[column] -= 8;
+    }
+}
+
+/**
+ * @brief Appends an unsigned LEB128 varint to a column.
+ * @param bytes The column.
+ * @param value The value.
+ */
+static void appendVarint(std::vector<uint8_t> &bytes, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @brief Appends the bytes of a value to a column.
+ * @param bytes The column.
+ * @param value The value.
+ */
+template <typename T>
+static void appendValue(std::vector<uint8_t> &bytes, const T &value)
+{
+    const uint8_t *start = reinterpret_cast<const uint8_t *>(&value);
+    bytes.insert(bytes.end(), start, start + sizeof(value));
+}
+
+/**
+ * @brief Gets the size of a packed column.
+ * @param values The number of values.
+ * @param bits The bits per value.
+ * @return The size in bytes, the last byte padded with zeros.
+ */
+static size_t packedSize(size_t values, int bits)
+{
+    return (values * bits + 7) / 8;
+}
+
+/**
+ * @brief Creates the trace file and writes its header.
+ * @param path The trace file, replaced if it exists.
+ * @param info The columns, teams and traced games.
+ * @return False if the file could not be written.
+ */
+bool SeasonTraceWriter::open(const std::string &path, const SeasonTraceInfo &info)
+{
+    filename = path;
+    columns = info.columns;
+    writeFailed = false;
+    gameIds.clear();
+    for (const auto &game : info.games)
+    {
+        gameIds.push_back(game.gameId);
+    }
+
+    std::vector<uint8_t> header(TRACE_MAGIC, TRACE_MAGIC + sizeof(TRACE_MAGIC));
+    appendValue(header, VERSION);
+    appendValue(header, columns);
+    appendValue(header, static_cast<uint32_t>(info.teams.size()));
+    appendValue(header, static_cast<uint32_t>(info.games.size()));
+    appendValue(header, info.seed);
+    for (const auto &team : info.teams)
+    {
+        char abbreviation[8] = {};
+        std::memcpy(abbreviation, team.data(), std::min(team.size(), sizeof(abbreviation) - 1));
+        header.insert(header.end(), abbreviation, abbreviation + sizeof(abbreviation));
+    }
+    for (const auto &game : info.games)
+    {
+        appendValue(header, game);
+    }
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(header.data()), static_cast<std::streamsize>(header.size())))
+    {
+        std::cerr << "Error: Could not write trace " << filename << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes a simulated season into a worker's block.
+ *
+ * The block is written first if the season does not follow its last one, and after the
+ * season if that fills it.
+ *
+ * @param block The worker's block.
+ * @param season The index of the season.
+ * @param state The simulated season.
+ */
+void SeasonTraceWriter::record(SeasonTraceBlock &block, uint64_t season, const SeasonState &state)
+{
+    if (block.numSeasons > 0 && season != block.firstSeason + block.numSeasons)
+    {
+        finishBlock(block);
+    }
+    if (block.numSeasons == 0)
+    {
+        block.firstSeason = season;
+    }
+
+    if (columns & TRACE_OUTCOMES)
+    {
+        for (uint16_t gameId : gameIds)
+        {
+            int homeScore = state.gameHomeScore[gameId];
+            int awayScore = state.gameAwayScore[gameId];
+            int outcome = homeScore > awayScore ? TRACE_HOME_WIN : homeScore < awayScore ? TRACE_AWAY_WIN : TRACE_TIE;
+            packBits(block, OUTCOMES_COLUMN, outcome, OUTCOME_BITS);
+        }
+    }
+
+    if (columns & TRACE_SCORES)
+    {
+        std::vector<uint8_t> &bytes = block.columns[SCORES_COLUMN];
+        for (uint16_t gameId : gameIds)
+        {
+            int32_t homeScore = state.gameHomeScore[gameId];
+            int32_t delta = state.gameAwayScore[gameId] - homeScore;
+            appendVarint(bytes, static_cast<uint32_t>(homeScore));
+            appendVarint(bytes, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+        }
+    }
+
+    if (columns & TRACE_ELO)
+    {
+        for (int team = 0; team < state.numTeams; ++team)
+        {
+            appendValue(block.columns[ELO_COLUMN], static_cast<float>(state.teamElo[team]));
+        }
+    }
+
+    if (columns & TRACE_SEEDS)
+    {
+        std::array<uint8_t, MAX_TEAMS> teamSeeds{};
+        for (const auto &seeds : state.playoffSeeds)
+        {
+            for (int seedNumber = 0; seedNumber < PLAYOFF_TEAMS; ++seedNumber)
+            {
+                teamSeeds[seeds[seedNumber]] = static_cast<uint8_t>(seedNumber + 1);
+            }
+        }
+        for (int team = 0; team < state.numTeams; ++team)
+        {
+            packBits(block, SEEDS_COLUMN, teamSeeds[team], TEAM_CODE_BITS);
+        }
+    }
+
+    if (columns & TRACE_PLAYOFFS)
+    {
+        for (int team = 0; team < state.numTeams; ++team)
+        {
+            packBits(block, PLAYOFFS_COLUMN, static_cast<uint32_t>(state.playoffRound[team]), TEAM_CODE_BITS);
+        }
+    }
+
+    if (columns & TRACE_WEIGHTS)
+    {
+        appendValue(block.columns[WEIGHTS_COLUMN], state.weight);
+    }
+
+    if (++block.numSeasons == BLOCK_SEASONS)
+    {
+        finishBlock(block);
+    }
+}
+
+/**
+ * @brief Writes the seasons of a worker's block to the trace and empties the block.
+ * @param block The worker's block; its buffers keep their capacity.
+ */
+void SeasonTraceWriter::finishBlock(SeasonTraceBlock &block)
+{
+    if (block.numSeasons == 0)
+    {
+        return;
+    }
+
+    BlockHeader header{};
+    header.firstSeason = block.firstSeason;
+    header.numSeasons = static_cast<uint32_t>(block.numSeasons);
+    for (int column = 0; column < NUM_TRACE_COLUMNS; ++column)
+    {
+        // Pad the last byte of a packed column
+        if (block.pendingBitCount[column] > 0)
+        {
+            block.columns[column].push_back(static_cast<uint8_t>(block.pendingBits[column]));
+        }
+        header.columnBytes[column] = static_cast<uint32_t>(block.columns[column].size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const auto &bytes : block.columns)
+        {
+            file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        }
+        writeFailed = writeFailed || !file;
+    }
+
+    block.numSeasons = 0;
+    for (int column = 0; column < NUM_TRACE_COLUMNS; ++column)
+    {
+        block.columns[column].clear();
+        block.pendingBits[column] = 0;
+        block.pendingBitCount[column] = 0;
+    }
+}
+
+/**
+ * @brief Closes the trace once every block has been finished.
+ * @return False if any part of the trace could not be written.
+ */
+bool SeasonTraceWriter::close()
+{
+    file.flush();
+    bool written = !writeFailed && file.good();
+    file.close();
+    if (!written)
+    {
+        std::cerr << "Error: Could not write trace " << filename << std::endl;
+    }
+    return written;
+}
+
+/**
+ * @brief Maps a trace and reads its header.
+ * @param path The trace file.
+ * @return False if the file is missing, not a trace of this version, or malformed.
+ */
+bool SeasonTraceReader::open(const std::string &path)
+{
+    filename = path;
+    if (!file.open(filename))
+    {
+        return false;
+    }
+
+    const size_t fixedSize = sizeof(TRACE_MAGIC) + 3 * sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t);
+    uint32_t version = 0;
+    if (file.size() >= fixedSize)
+    {
+        std::memcpy(&version, file.data() + sizeof(TRACE_MAGIC), sizeof(version));
+    }
+    if (file.size() < fixedSize || std::memcmp(file.data(), TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        version != SeasonTraceWriter::VERSION)
+    {
+        std::cerr << "Error: " << filename << " is not a season trace of this version" << std::endl;
+        return false;
+    }
+
+    uint32_t numTeams, numGames;
+    position = sizeof(TRACE_MAGIC) + sizeof(version);
+    std::memcpy(&traceInfo.columns, file.data() + position, sizeof(uint32_t));
+    std::memcpy(&numTeams, file.data() + position + 4, sizeof(uint32_t));
+    std::memcpy(&numGames, file.data() + position + 8, sizeof(uint32_t));
+    std::memcpy(&traceInfo.seed, file.data() + position + 12, sizeof(uint64_t));
+    position = fixedSize;
+
+    if (numTeams == 0 || numTeams > MAX_TEAMS || traceInfo.columns >> NUM_TRACE_COLUMNS != 0 ||
+        file.size() - position < numTeams * 8 + static_cast<size_t>(numGames) * sizeof(SeasonTraceGame))
+    {
+        std::cerr << "Error: Season trace " << filename << " is truncated or malformed" << std::endl;
+        return false;
+    }
+
+    traceInfo.teams.clear();
+    for (uint32_t team = 0; team < numTeams; ++team, position += 8)
+    {
+        traceInfo.teams.emplace_back(file.data() + position, strnlen(file.data() + position, 7));
+    }
+    traceInfo.games.resize(numGames);
+    std::memcpy(traceInfo.games.data(), file.data() + position, numGames * sizeof(SeasonTraceGame));
+    position += numGames * sizeof(SeasonTraceGame);
+
+    for (const auto &game : traceInfo.games)
+    {
+        if (game.home >= numTeams || game.away >= numTeams)
+        {
+            std::cerr << "Error: Season trace " << filename << " is truncated or malformed" << std::endl;
+            return false;
+        }
+    }
+
+    blockSeasons = 0;
+    blockSeason = 0;
+    failed = false;
+    return true;
+}
+
+/**
+ * @brief Gets the header of the opened trace.
+ * @return The columns, teams and traced games.
+ */
+const SeasonTraceInfo &SeasonTraceReader::info() const
+{
+    return traceInfo;
+}
+
+/**
+ * @brief Moves to the next block and checks the sizes of its columns.
+ * @return False at the end of the trace or if the block is malformed.
+ */
+bool SeasonTraceReader::nextBlock()
+{
+    if (position == file.size())
+    {
+        return false;
+    }
+
+    BlockHeader header;
+    if (file.size() - position < sizeof(header))
+    {
+        failed = true;
+    }
+    else
+    {
+        std::memcpy(&header, file.data() + position, sizeof(header));
+        position += sizeof(header);
+        failed = header.numSeasons == 0 || header.numSeasons > SeasonTraceWriter::BLOCK_SEASONS;
+    }
+
+    // Every column but the scores has a size fixed by the season count
+    const size_t seasons = failed ? 0 : header.numSeasons;
+    const size_t numTeams = traceInfo.teams.size();
+    const size_t expectedBytes[NUM_TRACE_COLUMNS] = {
+        packedSize(seasons * traceInfo.games.size(), OUTCOME_BITS), 0, seasons * numTeams * sizeof(float),
+        packedSize(seasons * numTeams, TEAM_CODE_BITS), packedSize(seasons * numTeams, TEAM_CODE_BITS), seasons * sizeof(double)};
+
+    for (int column = 0; column < NUM_TRACE_COLUMNS && !failed; ++column)
+    {
+        size_t bytes = header.columnBytes[column];
+        bool present = (traceInfo.columns >> column) & 1;
+        failed = file.size() - position < bytes || (!present && bytes != 0) ||
+                 (present && column != SCORES_COLUMN && bytes != expectedBytes[column]);
+        columnData[column] = reinterpret_cast<const uint8_t *>(file.data()) + position;
+        columnSize[column] = bytes;
+        columnPosition[column] = 0;
+        pendingBits[column] = 0;
+        pendingBitCount[column] = 0;
+        position += bytes;
+    }
+
+    if (failed)
+    {
+        std::cerr << "Error: Season trace " << filename << " is truncated or malformed" << std::endl;
+        return false;
+    }
+    blockFirstSeason = header.firstSeason;
+    blockSeasons = static_cast<int>(header.numSeasons);
+    blockSeason = 0;
+    return true;
+}
+
+/**
+ * @brief Decodes the next season of the trace.
+ * @param record Set to the season; columns missing from the trace keep their defaults.
+ * @return False at the end of the trace or if it is malformed.
+ */
+bool SeasonTraceReader::nextSeason(SeasonTraceRecord &record)
+{
+    if (failed || (blockSeason == blockSeasons && !nextBlock()))
+    {
+        return false;
+    }
+
+    // Reads a value of a packed column; the column sizes were checked by nextBlock
+    auto unpackBits = [this](int column, int bits)
+    {
+        while (pendingBitCount[column] < bits)
+        {
+            pendingBits[column] |= static_cast<uint64_t>(columnData[column][columnPosition[column]++]) << pendingBitCount[column];
+            pendingBitCount[column] += 8;
+        }
+        uint32_t value = static_cast<uint32_t>(pendingBits[column] & ((1u << bits) - 1));
+        pendingBits[column] >>= bits;
+        pendingBitCount[column] -= bits;
+        return value;
+    };
+
+    // Reads a varint of the scores column, flagging the trace as failed past its end
+    auto readVarint = [this]()
+    {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 32; shift += 7)
+        {
+            if (columnPosition[SCORES_COLUMN] == columnSize[SCORES_COLUMN])
+            {
+                break;
+            }
+            uint8_t byte = columnData[SCORES_COLUMN][columnPosition[SCORES_COLUMN]++];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
+        }
+        failed = true;
+        return value;
+    };
+
+    const size_t numTeams = traceInfo.teams.size();
+    const size_t numGames = traceInfo.games.size();
+    record.season = blockFirstSeason + blockSeason++;
+
+    if (traceInfo.columns & TRACE_OUTCOMES)
+    {
+        record.outcomes.resize(numGames);
+        for (size_t game = 0; game < numGames; ++game)
+        {
+            record.outcomes[game] = static_cast<uint8_t>(unpackBits(OUTCOMES_COLUMN, OUTCOME_BITS));
+        }
+    }
+
+    if (traceInfo.columns & TRACE_SCORES)
+    {
+        record.homeScores.resize(numGames);
+        record.awayScores.resize(numGames);
+        for (size_t game = 0; game < numGames; ++game)
+        {
+            uint32_t homeScore = readVarint();
+            uint32_t delta = readVarint();
+            record.homeScores[game] = static_cast<int16_t>(homeScore);
+            record.awayScores[game] = static_cast<int16_t>(homeScore + ((delta >> 1) ^ (0u - (delta & 1))));
+        }
+    }
+
+    if (traceInfo.columns & TRACE_ELO)
+    {
+        std::memcpy(record.elo.data(), columnData[ELO_COLUMN] + columnPosition[ELO_COLUMN], numTeams * sizeof(float));
+        columnPosition[ELO_COLUMN] += numTeams * sizeof(float);
+    }
+
+    if (traceInfo.columns & TRACE_SEEDS)
+    {
+        for (size_t team = 0; team < numTeams; ++team)
+        {
+            record.seeds[team] = static_cast<uint8_t>(unpackBits(SEEDS_COLUMN, TEAM_CODE_BITS));
+        }
+    }
+
+    if (traceInfo.columns & TRACE_PLAYOFFS)
+    {
+        for (size_t team = 0; team < numTeams; ++team)
+        {
+            record.playoffRound[team] = static_cast<uint8_t>(unpackBits(PLAYOFFS_COLUMN, TEAM_CODE_BITS));
+        }
+    }
+
+    if (traceInfo.columns & TRACE_WEIGHTS)
+    {
+        std::memcpy(&record.weight, columnData[WEIGHTS_COLUMN] + columnPosition[WEIGHTS_COLUMN], sizeof(double));
+        columnPosition[WEIGHTS_COLUMN] += sizeof(double);
+    }
+
+    if (failed)
+    {
+        std::cerr << "Error: Season trace " << filename << " is truncated or malformed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reports whether the trace turned out to be malformed while reading it.
+ * @return True if an error was reported.
+ */
+bool SeasonTraceReader::hasFailed() const
+{
+    return failed;
+}
@@ -0,0 +1,142 @@
+#ifndef SEASONTRACE_H
+#define SEASONTRACE_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "SeasonState.h"
+
+// Columns of a season trace, combined into a bit mask
+enum TraceColumn : uint32_t
+{
+    TRACE_OUTCOMES = 1 << 0, // Result of every simulated game, 2 bits each
+    TRACE_SCORES = 1 << 1,   // Scores of every simulated game as varints
+    TRACE_ELO = 1 << 2,      // Final Elo rating of every team as a float
+    TRACE_SEEDS = 1 << 3,    // Playoff seed of every team, 3 bits each
+    TRACE_PLAYOFFS = 1 << 4, // Playoff round every team reached, 3 bits each
+    TRACE_WEIGHTS = 1 << 5   // Importance sampling weight of the season as a double
+};
+constexpr int NUM_TRACE_COLUMNS = 6;
+constexpr uint32_t TRACE_DEFAULT_COLUMNS = TRACE_OUTCOMES | TRACE_SEEDS | TRACE_PLAYOFFS;
+
+// Codes of the outcomes column
+constexpr int TRACE_AWAY_WIN = 0;
+constexpr int TRACE_HOME_WIN = 1;
+constexpr int TRACE_TIE = 2;
+
+bool parseTraceColumns(const std::string &list, uint32_t &columns);
+const char *traceColumnName(int column);
+
+// A simulated game of a trace, in the order of the outcomes and scores columns
+struct SeasonTraceGame
+{
+    uint16_t gameId; // Game id in the simulator's season state
+    uint8_t home;    // Schedule index of the home team
+    uint8_t away;    // Schedule index of the away team
+    uint8_t week;    // Week of the game (0-based)
+    uint8_t reserved;
+};
+
+// What a trace describes, stored once in front of the season blocks
+struct SeasonTraceInfo
+{
+    uint32_t columns = TRACE_DEFAULT_COLUMNS; // Columns present in every block
+    uint64_t seed = 0;                        // Seed of the traced run
+    std::vector<std::string> teams;           // Abbreviation per schedule index
+    std::vector<SeasonTraceGame> games;       // Games not complete before the run
+};
+
+// Seasons of a trace block, encoded column by column. Every worker fills a block of
+// its own and hands it to the writer once it is full or the next season does not
+// follow the last one.
+struct SeasonTraceBlock
+{
+    uint64_t firstSeason = 0; // Index of the first season of the block
+    int numSeasons = 0;       // Seasons in the block
+    std::array<std::vector<uint8_t>, NUM_TRACE_COLUMNS> columns; // Encoded bytes per column
+    std::array<uint64_t, NUM_TRACE_COLUMNS> pendingBits{};       // Bits of the packed columns not yet in a byte
+    std::array<int, NUM_TRACE_COLUMNS> pendingBitCount{};        // Number of those bits
+};
+
+// One season decoded from a trace
+struct SeasonTraceRecord
+{
+    uint64_t season = 0;                        // Index of the season in its run
+    double weight = 1.0;                        // Importance sampling weight, 1 without the column
+    std::vector<uint8_t> outcomes;              // Outcome code per traced game
+    std::vector<int16_t> homeScores;            // Home score per traced game
+    std::vector<int16_t> awayScores;            // Away score per traced game
+    std::array<float, MAX_TEAMS> elo{};         // Final Elo rating per team
+    std::array<uint8_t, MAX_TEAMS> seeds{};     // Playoff seed per team, 0 for none
+    std::array<uint8_t, MAX_TEAMS> playoffRound{}; // Furthest playoff round per team
+};
+
+// Writer of a columnar binary trace of every simulated season, for analysis outside
+// the simulator. The file is a header with the teams and the simulated games, then
+// blocks of up to BLOCK_SEASONS seasons. A block starts with its first season, its
+// season count and the byte size of every column, followed by the columns:
+//
+//   outcomes  2-bit outcome code per game, packed across the seasons of the block
+//   scores    home score as a varint and the away score as a zigzag varint delta from it
+//   elo       float per team
+//   seeds     3-bit seed per team, packed like the outcomes
+//   playoffs  3-bit playoff round per team, packed like the outcomes
+//   weights   double per season, only written with importance sampling
+//
+// Blocks are written in the order they are finished, so with several workers the
+// seasons are not sorted; every block names its first season instead. Values are in
+// the byte order of the machine that wrote the trace.
+class SeasonTraceWriter
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int BLOCK_SEASONS = 4096;
+
+    bool open(const std::string &path, const SeasonTraceInfo &info);
+    void record(SeasonTraceBlock &block, uint64_t season, const SeasonState &state);
+    void finishBlock(SeasonTraceBlock &block);
+    bool close();
+
+private:
+    std::ofstream file;         // The trace file
+    std::string filename;       // Name of the trace file, for error messages
+    uint32_t columns = 0;       // Columns written
+    std::vector<uint16_t> gameIds; // Game id of every traced game
+    std::mutex mutex;           // Serializes the block writes of the workers
+    bool writeFailed = false;   // Whether a block could not be written
+};
+
+// Reader of season traces. The file is mapped into memory and decoded one season at
+// a time, in the order the blocks were written.
+class SeasonTraceReader
+{
+public:
+    bool open(const std::string &path);
+    const SeasonTraceInfo &info() const;
+    bool nextSeason(SeasonTraceRecord &record);
+    bool hasFailed() const;
+
+private:
+    bool nextBlock();
+
+    MappedFile file;             // Mapping of the trace
+    std::string filename;        // Name of the trace, for error messages
+    SeasonTraceInfo traceInfo;   // Header of the trace
+    size_t position = 0;         // Start of the next block
+    uint64_t blockFirstSeason = 0; // First season of the current block
+    int blockSeasons = 0;        // Seasons in the current block
+    int blockSeason = 0;         // Next season of the current block to decode
+    std::array<const uint8_t *, NUM_TRACE_COLUMNS> columnData{}; // Start of each column of the current block
+    std::array<size_t, NUM_TRACE_COLUMNS> columnSize{};           // Size of each column of the current block
+    std::array<size_t, NUM_TRACE_COLUMNS> columnPosition{};       // Read position in bytes within each column
+    std::array<uint64_t, NUM_TRACE_COLUMNS> pendingBits{};        // Bits of the packed columns read ahead
+    std::array<int, NUM_TRACE_COLUMNS> pendingBitCount{};         // Number of those bits
+    bool failed = false;         // Whether the trace turned out to be corrupt
+};
+
+#endif // SEASONTRACE_H
@@ -0,0 +1,52 @@
+#ifndef SIMDLANES_H
+#define SIMDLANES_H
+
+#include <cstdint>
+#include <cstring>
+
+// Number of seasons simulated in lockstep by the batched season kernel.
+// The lane types below are GCC/Clang vector extensions, so the compiler maps
+// them onto whatever vector units -march enables: one AVX-512 register, two
+// AVX2 registers or four SSE2 registers for the default of 8 doubles.
+#ifndef SIMD_LANES
+#define SIMD_LANES 8
+#endif
+
+typedef double LaneDouble __attribute__((vector_size(SIMD_LANES * sizeof(double))));
+typedef int64_t LaneInt __attribute__((vector_size(SIMD_LANES * sizeof(int64_t))));
+typedef uint64_t LaneUInt __attribute__((vector_size(SIMD_LANES * sizeof(uint64_t))));
+
+/**
+ * @brief Loads one value per lane from memory.
+ * @param values Pointer to SIMD_LANES consecutive doubles.
+ * @return The lanes.
+ */
+inline LaneDouble loadLanes(const double *values)
+{
+    LaneDouble lanes;
+    std::memcpy(&lanes, values, sizeof(lanes));
+    return lanes;
+}
+
+/**
+ * @brief Stores one value per lane to memory.
+ * @param values Pointer to SIMD_LANES consecutive doubles.
+ * @param lanes The lanes to store.
+ */
+inline void storeLanes(double *values, LaneDouble lanes)
+{
+    std::memcpy(values, &lanes, sizeof(lanes));
+}
+
+/**
+ * @brief Broadcasts a value to every lane.
+ * @param value The value.
+ * @return The lanes.
+ */
+inline LaneDouble broadcastLanes(double value)
+{
+    LaneDouble lanes = {};
+    return lanes + value;
+}
+
+#endif // SIMDLANES_H
@@ -37,7 +37,7 @@ Team::~Team() {}
  * @brief Get the name of the team.
  * @return The name of the team.
  */
-std::string Team::getName() const
+const std::string &Team::getName() const
 {
     return name;
 }
@@ -46,7 +46,7 @@ std::string Team::getName() const
  * @brief Get the abbreviation of the team.
  * @return The abbreviation of the team.
  */
-std::string Team::getAbbreviation() const
+const std::string &Team::getAbbreviation() const
 {
     return abbreviation;
 }
@@ -55,7 +55,7 @@ std::string Team::getAbbreviation() const
  * @brief Get the color of the team.
  * @return The color of the team.
  */
-std::string Team::getColor() const
+const std::string &Team::getColor() const
 {
     return color;
 }
@@ -125,6 +125,15 @@ void Team::updateEloRating(double eloChange)
     eloRating += eloChange;
 }
 
+/**
+ * @brief Set the Elo rating of the team.
+ * @param elo The new Elo rating.
+ */
+void Team::setEloRating(double elo)
+{
+    eloRating = elo;
+}
+
 /**
  * @brief Update the win count of the team.
  * @param result The result to be added to the win count.
@@ -134,6 +143,15 @@ void Team::updateWinCount(float result)
     winCount += result;
 }
 
+/**
+ * @brief Set the win count of the team.
+ * @param wins The new win count.
+ */
+void Team::setWinCount(float wins)
+{
+    winCount = wins;
+}
+
 /**
  * @brief Set the playoff status of the team.
  * @param madePlayoffs True if the team made the playoffs, false otherwise.
@@ -152,27 +170,6 @@ void Team::setPlayoffRound(int round)
     playoffRound = round;
 }
 
-// Functions for tracking losses
-
-/**
- * @brief Add a loss to the team's record.
- * @param opponent A shared pointer to the opponent team.
- * @param pointDifferential The point differential of the loss.
- */
-void Team::addLoss(const std::shared_ptr<Team> &opponent, int pointDifferential)
-{
-    losses[opponent] = pointDifferential;
-}
-
-/**
- * @brief Get the losses of the team.
- * @return A reference to a map containing the losses of the team.
- */
-const std::map<std::shared_ptr<Team>, int> &Team::getLosses() const
-{
-    return losses;
-}
-
 /**
  * @brief Reset the team's attributes to their original values.
  */
@@ -182,5 +179,4 @@ void Team::resetTeam()
     winCount = 0.0;
     playoffStatus = false;
     playoffRound = 0;
-    losses.clear();
 }
\ No newline at end of file
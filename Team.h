@@ -4,9 +4,11 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <map>
 #include <memory>
 
+// Maximum number of teams in the league
+constexpr int MAX_TEAMS = 32;
+
 // Struct to represent a city with a name and geographical coordinates
 struct City
 {
@@ -30,9 +32,9 @@ public:
     ~Team();
 
     // Getter functions
-    std::string getName() const;
-    std::string getAbbreviation() const;
-    std::string getColor() const;
+    const std::string &getName() const;
+    const std::string &getAbbreviation() const;
+    const std::string &getColor() const;
     double getEloRating() const;
     const City &getCity() const;
     int getScheduleIndex() const;
@@ -42,15 +44,13 @@ public:
 
     // Setter functions
     void updateEloRating(double eloChange);
+    void setEloRating(double elo);
     void updateWinCount(float result);
+    void setWinCount(float wins);
     void setPlayoffStatus(bool madePlayoffs);
     void setPlayoffRound(int round);
     void resetTeam();
 
-    // Functions for tracking losses
-    void addLoss(const std::shared_ptr<Team> &opponent, int pointDifferential);
-    const std::map<std::shared_ptr<Team>, int> &getLosses() const;
-
 private:
     // Private member variables
     std::string name;         // Team name
@@ -63,9 +63,6 @@ private:
     float winCount;           // Number of wins
     bool playoffStatus;       // Whether the team made the playoffs
     int playoffRound;         // The playoff round the team reached
-
-    // Map to store losses with point differentials
-    std::map<std::shared_ptr<Team>, int> losses;
 };
 
 #endif // TEAM_H
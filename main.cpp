@@ -1,21 +1,224 @@
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include "ForecastServer.h"
 #include "NFLSim.h"
 
 int main(int argc, char *argv[])
 {
+    const std::string usage = std::string("Usage: ") + argv[0] +
+                              " <filename> [--seed <n>] [--fast-math] [--compare-math] [--antithetic] [--control-variates]"
+                              " [--target <team> [--tilt <elo>]] [--checkpoint <file> [--checkpoint-every <seasons>]]"
+                              " [--resume <file>] [--distributions] [--distributions-csv <file>]"
+                              " [--batch --seasons <n> [--teams <file>] [--threads <n>] [--output <file>]]"
+                              " [--serve <socket> [--teams <file>] [--threads <n>]] [--cache-size <n>] [--cache-dir <dir>]"
+                              " [--compile <image> [--teams <file>]] [--compact] [--trace <file> [--trace-columns <list>]]";
+
     // Check if the correct number of arguments is provided
-    if (argc != 2)
+    if (argc < 2)
     {
-        std::cerr << "Usage: " << argv[0] << " <filename>" << std::endl;
+        std::cerr << usage << std::endl;
         return 1;
     }
 
     // Get the file name from command-line arguments
     std::string filename = argv[1];
 
-    // Pass the file name to NFLSim
-    NFLSim newSim(filename);
+    SimulationOptions options;
+    bool seedGiven = false;
+    bool batch = false;
+    std::string socketPath;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--seed" && i + 1 < argc)
+        {
+            try
+            {
+                options.seed = std::stoull(argv[++i]);
+                seedGiven = true;
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Invalid seed: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--fast-math")
+        {
+            options.mathMode = MathMode::Fast;
+        }
+        else if (option == "--compare-math")
+        {
+            options.compareMath = true;
+        }
+        else if (option == "--antithetic")
+        {
+            options.antithetic = true;
+        }
+        else if (option == "--control-variates")
+        {
+            options.controlVariates = true;
+        }
+        else if (option == "--target" && i + 1 < argc)
+        {
+            options.importanceTarget = argv[++i];
+        }
+        else if (option == "--tilt" && i + 1 < argc)
+        {
+            try
+            {
+                options.importanceTilt = std::stod(argv[++i]);
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Invalid tilt: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--checkpoint" && i + 1 < argc)
+        {
+            options.checkpointFile = argv[++i];
+        }
+        else if (option == "--checkpoint-every" && i + 1 < argc)
+        {
+            try
+            {
+                options.checkpointInterval = std::stoi(argv[++i]);
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Invalid checkpoint interval: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--resume" && i + 1 < argc)
+        {
+            options.resumeFile = argv[++i];
+        }
+        else if (option == "--distributions")
+        {
+            options.showDistributions = true;
+        }
+        else if (option == "--distributions-csv" && i + 1 < argc)
+        {
+            options.distributionsFile = argv[++i];
+        }
+        else if (option == "--batch")
+        {
+            batch = true;
+        }
+        else if ((option == "--seasons" || option == "--threads") && i + 1 < argc)
+        {
+            try
+            {
+                int value = std::stoi(argv[++i]);
+                if (value <= 0)
+                {
+                    throw std::invalid_argument(option);
+                }
+                (option == "--seasons" ? options.batchSeasons : options.numThreads) = value;
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Invalid " << option.substr(2) << ": " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--teams" && i + 1 < argc)
+        {
+            options.teamsFile = argv[++i];
+        }
+        else if (option == "--output" && i + 1 < argc)
+        {
+            options.outputFile = argv[++i];
+        }
+        else if (option == "--cache-size" && i + 1 < argc)
+        {
+            try
+            {
+                options.cacheEntries = std::stoi(argv[++i]);
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Invalid cache size: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--cache-dir" && i + 1 < argc)
+        {
+            options.cacheDirectory = argv[++i];
+        }
+        else if (option == "--compact")
+        {
+            options.compactSchedule = true;
+        }
+        else if (option == "--trace" && i + 1 < argc)
+        {
+            options.traceFile = argv[++i];
+        }
+        else if (option == "--trace-columns" && i + 1 < argc)
+        {
+            if (!parseTraceColumns(argv[++i], options.traceColumns))
+            {
+                std::cerr << "Invalid trace columns: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (option == "--compile" && i + 1 < argc)
+        {
+            options.compileFile = argv[++i];
+        }
+        else if (option == "--serve" && i + 1 < argc)
+        {
+            socketPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << option << std::endl;
+            std::cerr << usage << std::endl;
+            return 1;
+        }
+    }
+
+    // Batch mode runs a fixed number of seasons without any prompt
+    if (batch != (options.batchSeasons > 0))
+    {
+        std::cerr << "--batch and --seasons must be given together" << std::endl;
+        return 1;
+    }
+
+    if (options.controlVariates && !options.importanceTarget.empty())
+    {
+        std::cerr << "--control-variates cannot be combined with --target" << std::endl;
+        return 1;
+    }
+
+    // Serve forecasts from the loaded league until the process is stopped
+    if (!socketPath.empty())
+    {
+        auto simulator = NFLSimulator::load(filename, options.teamsFile, options.cacheDirectory, options.cacheEntries);
+        if (!simulator)
+        {
+            return 1;
+        }
+        int workers = options.numThreads > 0 ? options.numThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        ForecastServer server(*simulator, workers);
+        return server.serve(socketPath) ? 0 : 1;
+    }
+
+    // Use the given seed, or draw one so the run can still be reproduced
+    if (!seedGiven)
+    {
+        std::random_device rd;
+        options.seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    // Pass the file name and options to NFLSim
+    NFLSim newSim(filename, options);
 
-    return 0;
+    return newSim.hasFailed() ? 1 : 0;
 }
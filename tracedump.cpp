@@ -0,0 +1,166 @@
+#include <iostream>
+#include <string>
+
+#include "ReportWriter.h"
+#include "SeasonTrace.h"
+
+// Outcome codes as letters for the home team: loss, win, tie
+static const char OUTCOME_LETTERS[] = {'L', 'W', 'T'};
+
+/**
+ * @brief Writes the header row of the season CSV.
+ * @param report The report to write to.
+ * @param info The header of the trace.
+ */
+static void writeColumnNames(ReportWriter &report, const SeasonTraceInfo &info)
+{
+    report.write("season");
+    if (info.columns & TRACE_WEIGHTS)
+    {
+        report.write(",weight");
+    }
+    for (uint32_t column : {TRACE_OUTCOMES, TRACE_SCORES})
+    {
+        if (!(info.columns & column))
+        {
+            continue;
+        }
+        for (const auto &game : info.games)
+        {
+            report.write(column == TRACE_OUTCOMES ? ",result_" : ",score_");
+            report.writeInt(game.week + 1);
+            report.write("_");
+            report.write(info.teams[game.away]);
+            report.write("@");
+            report.write(info.teams[game.home]);
+        }
+    }
+    for (uint32_t column : {TRACE_ELO, TRACE_SEEDS, TRACE_PLAYOFFS})
+    {
+        if (!(info.columns & column))
+        {
+            continue;
+        }
+        for (const auto &team : info.teams)
+        {
+            report.write(column == TRACE_ELO ? ",elo_" : column == TRACE_SEEDS ? ",seed_" : ",round_");
+            report.write(team);
+        }
+    }
+    report.endLine();
+}
+
+/**
+ * @brief Writes a decoded season as a CSV row.
+ * @param report The report to write to.
+ * @param info The header of the trace.
+ * @param record The season.
+ */
+static void writeSeason(ReportWriter &report, const SeasonTraceInfo &info, const SeasonTraceRecord &record)
+{
+    const size_t numTeams = info.teams.size();
+    report.writeInt(static_cast<long long>(record.season));
+    if (info.columns & TRACE_WEIGHTS)
+    {
+        report.write(",");
+        report.writeGeneral(record.weight);
+    }
+    if (info.columns & TRACE_OUTCOMES)
+    {
+        for (uint8_t outcome : record.outcomes)
+        {
+            report.write(",");
+            report.write(std::string_view(&OUTCOME_LETTERS[outcome < 3 ? outcome : 2], 1));
+        }
+    }
+    if (info.columns & TRACE_SCORES)
+    {
+        for (size_t game = 0; game < info.games.size(); ++game)
+        {
+            report.write(",");
+            report.writeInt(record.homeScores[game]);
+            report.write("-");
+            report.writeInt(record.awayScores[game]);
+        }
+    }
+    if (info.columns & TRACE_ELO)
+    {
+        for (size_t team = 0; team < numTeams; ++team)
+        {
+            report.write(",");
+            report.writeFixed(record.elo[team], 2);
+        }
+    }
+    if (info.columns & TRACE_SEEDS)
+    {
+        for (size_t team = 0; team < numTeams; ++team)
+        {
+            report.write(",");
+            report.writeInt(record.seeds[team]);
+        }
+    }
+    if (info.columns & TRACE_PLAYOFFS)
+    {
+        for (size_t team = 0; team < numTeams; ++team)
+        {
+            report.write(",");
+            report.writeInt(record.playoffRound[team]);
+        }
+    }
+    report.endLine();
+}
+
+// Prints a season trace written with --trace as CSV, one row per season in the order
+// of the file, or with --info only what the trace holds.
+int main(int argc, char *argv[])
+{
+    const std::string usage = std::string("Usage: ") + argv[0] + " <trace> [--info]";
+    if (argc < 2 || argc > 3 || (argc == 3 && std::string(argv[2]) != "--info"))
+    {
+        std::cerr << usage << std::endl;
+        return 1;
+    }
+
+    SeasonTraceReader reader;
+    if (!reader.open(argv[1]))
+    {
+        return 1;
+    }
+    const SeasonTraceInfo &info = reader.info();
+    SeasonTraceRecord record;
+
+    if (argc == 3)
+    {
+        long long seasons = 0;
+        while (reader.nextSeason(record))
+        {
+            ++seasons;
+        }
+        std::cout << "Seed: " << info.seed << "\nTeams: " << info.teams.size() << "\nSimulated games: " << info.games.size()
+                  << "\nSeasons: " << seasons << "\nColumns:";
+        for (int column = 0; column < NUM_TRACE_COLUMNS; ++column)
+        {
+            if ((info.columns >> column) & 1)
+            {
+                std::cout << " " << traceColumnName(column);
+            }
+        }
+        std::cout << std::endl;
+        return reader.hasFailed() ? 1 : 0;
+    }
+
+    // Flush the rows in chunks so the whole dump is never held in memory
+    ReportWriter report;
+    writeColumnNames(report, info);
+    long long rows = 0;
+    while (reader.nextSeason(record))
+    {
+        writeSeason(report, info, record);
+        if (++rows % 1024 == 0)
+        {
+            report.flush(std::cout);
+        }
+    }
+    report.flush(std::cout);
+    return reader.hasFailed() ? 1 : 0;
+}